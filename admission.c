@@ -0,0 +1,32 @@
+#include "admission.h"
+#include "ratelimit.h"
+#include <stdatomic.h>
+
+static atomic_llong lastLateMs;
+
+void admission_record_tick(int lateUs) {
+    if (lateUs <= ADMISSION_LATE_US) return;
+    atomic_store_explicit(&lastLateMs, ratelimit_now_ms(), memory_order_relaxed);
+}
+
+int admission_check(int64_t nowMs, int freeSlots, int queuedBytes, busy_reason_t *reason) {
+    int64_t late = atomic_load_explicit(&lastLateMs, memory_order_relaxed);
+    if (late != 0 && nowMs - late < ADMISSION_WINDOW_MS) {
+        // Nový pokus až keď okno bez meškania uplynie
+        *reason = BUSY_OVERLOAD;
+        return (int)(late + ADMISSION_WINDOW_MS - nowMs) + ADMISSION_RETRY_MS;
+    }
+    if (queuedBytes > ADMISSION_MAX_QUEUE) {
+        *reason = BUSY_OVERLOAD;
+        return ADMISSION_RETRY_MS;
+    }
+    if (freeSlots <= 0) {
+        *reason = BUSY_FULL;
+        return ADMISSION_RETRY_MS;
+    }
+    return 0;
+}
+
+int64_t admission_last_late_ms(void) {
+    return atomic_load_explicit(&lastLateMs, memory_order_relaxed);
+}
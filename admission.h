@@ -0,0 +1,28 @@
+#ifndef ADMISSION_H
+#define ADMISSION_H
+
+#include <stdint.h>
+#include "shared.h"
+
+// Riadenie prijímania spojení. Herné vlákna hlásia, o koľko tick meškal
+// voči plánu; hlavné vlákno pred prijatím spojenia zváži meškanie, voľné
+// miesta a neodoslané dáta klientov. Nové spojenie, ktoré by spomalilo
+// bežiace hry, server odmietne správou MSG_BUSY s časom na nový pokus.
+
+#define ADMISSION_BACKLOG 64         // Predvolená fronta listen (-q)
+#define ADMISSION_LATE_US 50000      // Tick meškajúci viac je preťaženie (10 % GAME_LOOP_MS)
+#define ADMISSION_WINDOW_MS 2000     // Po meškajúcom ticku sa toľko neprijíma
+#define ADMISSION_MAX_QUEUE 262144   // Neodoslané bajty všetkých klientov, nad ktoré sa neprijíma
+#define ADMISSION_RETRY_MS 1000      // Najkratší čas na nový pokus
+
+// Meškanie začiatku ticku voči plánu v µs (volá herné vlákno)
+void admission_record_tick(int lateUs);
+
+// Rozhodne o novom spojení: vráti 0 = prijať, inak čas na nový pokus v ms
+// a do *reason dôvod odmietnutia
+int admission_check(int64_t nowMs, int freeSlots, int queuedBytes, busy_reason_t *reason);
+
+// Kedy naposledy tick meškal (ms, ratelimit_now_ms), 0 = nikdy
+int64_t admission_last_late_ms(void);
+
+#endif // ADMISSION_H
@@ -0,0 +1,326 @@
+#include "aoi.h"
+#include <string.h>
+
+static int slot_test(const uint64_t *mask, int i) {
+    return (int)((mask[i >> 6] >> (i & 63)) & 1u);
+}
+
+static void slot_set(uint64_t *mask, int i) {
+    mask[i >> 6] |= 1ull << (i & 63);
+}
+
+static void slot_flip(uint64_t *mask, int i) {
+    mask[i >> 6] ^= 1ull << (i & 63);
+}
+
+static int forcedEncoding = -1;
+
+void aoi_force_encoding(int encoding) {
+    forcedEncoding = encoding;
+}
+
+void aoi_build_index(aoi_index_t *index, const game_engine_t *state) {
+    index->chunksX = (state->width + AOI_CHUNK - 1) / AOI_CHUNK;
+    index->chunksY = (state->height + AOI_CHUNK - 1) / AOI_CHUNK;
+    memset(index->chunkSnakes, 0,
+           (size_t)(index->chunksX * index->chunksY) * sizeof(index->chunkSnakes[0]));
+
+    for (int w = 0; w < ENGINE_MASK_WORDS; w++) {
+        uint64_t bits = state->aliveMask[w];
+        while (bits) {
+            int i = w * 64 + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            int lastChunk = -1;
+            for (int k = 0; k < state->length[i]; k++) {
+                position_t p = game_snake_cell(state, i, k);
+                int chunk = (p.y / AOI_CHUNK) * index->chunksX + p.x / AOI_CHUNK;
+                // Susedné články ležia väčšinou v tom istom bloku
+                if (chunk == lastChunk) continue;
+                slot_set(index->chunkSnakes[chunk], i);
+                lastChunk = chunk;
+            }
+        }
+    }
+}
+
+void aoi_reset(aoi_subscription_t *sub) {
+    memset(sub, 0, sizeof(*sub));
+    sub->gameId = -1;
+}
+
+// Roh výrezu v jednej osi; ak sa svet zmestí celý, výrez je celý svet
+static void view_axis(int center, int world, int view, int *origin, int *size, int *margin) {
+    if (world <= view) {
+        *origin = 0;
+        *size = world;
+        *margin = 0;
+        return;
+    }
+    *origin = ((center - view / 2) % world + world) % world;
+    *size = view;
+    *margin = VIEW_MARGIN;
+}
+
+// Súradnica relatívne k rohu výrezu na toruse, záporná pre okraj pred výrezom
+static int rel_coord(int p, int origin, int world, int size, int margin) {
+    int r = p - origin;
+    if (r < 0) r += world;
+    if (r >= size + margin && r >= world - margin) r -= world;
+    return r;
+}
+
+static int in_range(int r, int size, int margin) {
+    return r >= -margin && r < size + margin;
+}
+
+// Obsadenosť oblasti výrezu (výrez s okrajom) telami zapísaných hadíkov
+typedef struct ViewRegion {
+    int width;
+    int area;
+    int marginX;
+    int marginY;
+    uint8_t bits[(AOI_REGION_MAX + 7) / 8];
+} view_region_t;
+
+static void region_set(view_region_t *r, int rx, int ry) {
+    int i = (ry + r->marginY) * r->width + rx + r->marginX;
+    r->bits[i >> 3] |= (uint8_t)(1u << (i & 7));
+}
+
+static int region_test(const view_region_t *r, int i) {
+    return (r->bits[i >> 3] >> (i & 7)) & 1;
+}
+
+typedef struct ViewWriter {
+    char *buf;
+    int cap;
+    int used;
+} view_writer_t;
+
+static int put(view_writer_t *w, const void *data, int length) {
+    if (w->used + length > w->cap) return -1;
+    memcpy(w->buf + w->used, data, (size_t)length);
+    w->used += length;
+    return 0;
+}
+
+// Zapíše hadíka s článkami vo výreze; vráti 1 ak bol zapísaný
+static int write_snake(view_writer_t *w, const game_engine_t *state, int slot, int always,
+                       const view_header_t *h, view_region_t *region) {
+    int marginX = region->marginX, marginY = region->marginY;
+    int start = w->used;
+    view_snake_t vs;
+    memset(&vs, 0, sizeof(vs));
+    vs.slot = (int16_t)slot;
+    vs.score = state->score[slot];
+    if (game_player_alive(state, slot)) vs.flags |= VIEW_SNAKE_ALIVE;
+    if (game_player_paused(state, slot)) vs.flags |= VIEW_SNAKE_PAUSED;
+    if (put(w, &vs, sizeof(vs)) < 0) return 0;
+
+    if (vs.flags & VIEW_SNAKE_ALIVE) {
+        for (int k = 0; k < state->length[slot]; k++) {
+            position_t p = game_snake_cell(state, slot, k);
+            int rx = rel_coord(p.x, h->originX, state->width, h->viewWidth, marginX);
+            int ry = rel_coord(p.y, h->originY, state->height, h->viewHeight, marginY);
+            if (!in_range(rx, h->viewWidth, marginX) || !in_range(ry, h->viewHeight, marginY)) continue;
+            view_cell_t c = {(int8_t)rx, (int8_t)ry};
+            if (put(w, &c, sizeof(c)) < 0) break; // Plný buffer - pošli, čo sa zmestilo
+            region_set(region, rx, ry);
+            if (k == 0) vs.flags |= VIEW_SNAKE_HEAD;
+            vs.cellCount++;
+        }
+    }
+
+    if (vs.cellCount == 0 && !always) {
+        w->used = start; // Nič z neho nevidno
+        return 0;
+    }
+    memcpy(w->buf + start, &vs, sizeof(vs));
+    return 1;
+}
+
+// Behy striedavo voľných a obsadených políčok oblasti, vráti dĺžku alebo -1 nad cap
+static int encode_runs(const view_region_t *r, uint8_t *out, int cap) {
+    int used = 0, occupied = 0;
+    for (int i = 0; i < r->area; occupied = !occupied) {
+        int run = 0;
+        while (i < r->area && run < 255 && region_test(r, i) == occupied) {
+            run++;
+            i++;
+        }
+        if (used >= cap) return -1;
+        out[used++] = (uint8_t)run;
+    }
+    return used;
+}
+
+// Hadíci sú zapísaní od start ako LIST. Ak je tabuľka hláv s bitmapou alebo
+// behmi oblasti kratšia (husté výrezy, dlhé telá), prepíše ich na mieste.
+static void pick_encoding(view_writer_t *w, int start, view_header_t *h, const view_region_t *region) {
+    int tableLength = 0;
+    for (int s = 0, pos = start; s < h->snakeCount; s++) {
+        view_snake_t vs;
+        memcpy(&vs, w->buf + pos, sizeof(vs));
+        pos += (int)sizeof(vs) + vs.cellCount * (int)sizeof(view_cell_t);
+        tableLength += (int)sizeof(vs) + ((vs.flags & VIEW_SNAKE_HEAD) ? (int)sizeof(view_cell_t) : 0);
+    }
+
+    int encoding = VIEW_ENC_LIST;
+    int best = w->used - start;
+    int bitmapLength = (region->area + 7) / 8;
+    if (tableLength + bitmapLength < best) {
+        encoding = VIEW_ENC_BITMAP;
+        best = tableLength + bitmapLength;
+    }
+    uint8_t runs[AOI_REGION_MAX + 1];
+    int runCap = forcedEncoding == VIEW_ENC_RLE ? (int)sizeof(runs) : best - tableLength - 1;
+    int runLength = runCap > 0 ? encode_runs(region, runs, runCap) : -1;
+    if (runLength >= 0) encoding = VIEW_ENC_RLE;
+    if (forcedEncoding >= 0) encoding = forcedEncoding;
+    h->encoding = (uint8_t)encoding;
+    if (encoding == VIEW_ENC_LIST) return;
+
+    // Tabuľka hláv je kratšia než zoznam, zapisuje sa za čítaním
+    int in = start;
+    w->used = start;
+    for (int s = 0; s < h->snakeCount; s++) {
+        view_snake_t vs;
+        memcpy(&vs, w->buf + in, sizeof(vs));
+        in += (int)sizeof(vs);
+        int cells = vs.cellCount;
+        vs.cellCount = (vs.flags & VIEW_SNAKE_HEAD) ? 1 : 0;
+        memcpy(w->buf + w->used, &vs, sizeof(vs));
+        w->used += (int)sizeof(vs);
+        memmove(w->buf + w->used, w->buf + in, (size_t)vs.cellCount * sizeof(view_cell_t));
+        w->used += vs.cellCount * (int)sizeof(view_cell_t);
+        in += cells * (int)sizeof(view_cell_t);
+    }
+    if (encoding == VIEW_ENC_BITMAP) {
+        put(w, region->bits, bitmapLength);
+    } else {
+        put(w, runs, runLength);
+    }
+}
+
+// Označí bloky jednej osi, do ktorých zasahuje rozsah [start, start + size) na toruse.
+// Rozsah sa rozdelí na najviac dva úseky vo svete; posledný blok môže byť neúplný,
+// takže hranice blokov za okrajom sveta nie sú násobkami AOI_CHUNK.
+static void axis_chunks(int start, int size, int world, uint8_t *mark) {
+    memset(mark, 0, (size_t)((world + AOI_CHUNK - 1) / AOI_CHUNK));
+    if (size >= world) {
+        start = 0;
+        size = world;
+    }
+    start = (start % world + world) % world;
+    int end = start + size - 1;
+    int firstEnd = end < world ? end : world - 1;
+    for (int c = start / AOI_CHUNK; c <= firstEnd / AOI_CHUNK; c++) mark[c] = 1;
+    if (end >= world) {
+        for (int c = 0; c <= (end - world) / AOI_CHUNK; c++) mark[c] = 1;
+    }
+}
+
+int aoi_encode_view(const aoi_index_t *index, const game_engine_t *state, int selfSlot,
+                    aoi_subscription_t *sub, char *buf, int cap) {
+    if (sub->gameId != state->gameId) {
+        aoi_reset(sub);
+        sub->gameId = state->gameId;
+    }
+    if (selfSlot >= state->maxSnakes || (selfSlot >= 0 && state->playerId[selfSlot] == -1)) {
+        selfSlot = -1;
+    }
+
+    view_header_t h;
+    memset(&h, 0, sizeof(h));
+    h.gameId = state->gameId;
+    h.elapsedTime = state->elapsedTime;
+    h.tickStampUs = state->tickStampUs;
+    h.playerCount = state->playerCount;
+    h.gameRunning = state->gameRunning;
+    h.worldWidth = state->width;
+    h.worldHeight = state->height;
+    h.selfSlot = selfSlot;
+
+    // Výrez sa centruje na hlavu hráča (aj mŕtveho), divák vidí stred sveta
+    int centerX = selfSlot >= 0 ? state->headX[selfSlot] : state->width / 2;
+    int centerY = selfSlot >= 0 ? state->headY[selfSlot] : state->height / 2;
+    int marginX, marginY;
+    view_axis(centerX, state->width, VIEW_WIDTH, &h.originX, &h.viewWidth, &marginX);
+    view_axis(centerY, state->height, VIEW_HEIGHT, &h.originY, &h.viewHeight, &marginY);
+    h.marginX = (int8_t)marginX;
+    h.marginY = (int8_t)marginY;
+
+    view_region_t region;
+    region.width = h.viewWidth + 2 * marginX;
+    region.area = region.width * (h.viewHeight + 2 * marginY);
+    region.marginX = marginX;
+    region.marginY = marginY;
+    memset(region.bits, 0, (size_t)(region.area + 7) / 8);
+
+    view_writer_t w = {buf, cap, sizeof(h)};
+    if (cap < (int)sizeof(h)) return 0;
+
+    // Kandidáti z blokov, ktoré pokrývajú výrez aj s okrajom
+    uint64_t candidates[ENGINE_MASK_WORDS];
+    memset(candidates, 0, sizeof(candidates));
+    uint8_t rowsY[AOI_MAX_CHUNKS_Y], colsX[AOI_MAX_CHUNKS_X];
+    axis_chunks(h.originY - marginY, h.viewHeight + 2 * marginY, state->height, rowsY);
+    axis_chunks(h.originX - marginX, h.viewWidth + 2 * marginX, state->width, colsX);
+    for (int chunkY = 0; chunkY < index->chunksY; chunkY++) {
+        if (!rowsY[chunkY]) continue;
+        for (int chunkX = 0; chunkX < index->chunksX; chunkX++) {
+            if (!colsX[chunkX]) continue;
+            const uint64_t *mask = index->chunkSnakes[chunkY * index->chunksX + chunkX];
+            for (int k = 0; k < ENGINE_MASK_WORDS; k++) candidates[k] |= mask[k];
+        }
+    }
+
+    uint64_t visible[ENGINE_MASK_WORDS];
+    memset(visible, 0, sizeof(visible));
+    if (selfSlot >= 0 && write_snake(&w, state, selfSlot, 1, &h, &region)) {
+        slot_set(visible, selfSlot);
+        h.snakeCount++;
+    }
+    for (int k = 0; k < ENGINE_MASK_WORDS && h.snakeCount < VIEW_MAX_SNAKES; k++) {
+        uint64_t bits = candidates[k];
+        while (bits && h.snakeCount < VIEW_MAX_SNAKES) {
+            int i = k * 64 + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            if (i == selfSlot) continue;
+            if (write_snake(&w, state, i, 0, &h, &region)) {
+                slot_set(visible, i);
+                h.snakeCount++;
+            }
+        }
+    }
+
+    pick_encoding(&w, sizeof(h), &h, &region);
+
+    for (int f = 0; f < state->foodCount; f++) {
+        int rx = rel_coord(state->food[f].x, h.originX, state->width, h.viewWidth, marginX);
+        int ry = rel_coord(state->food[f].y, h.originY, state->height, h.viewHeight, marginY);
+        if (!in_range(rx, h.viewWidth, marginX) || !in_range(ry, h.viewHeight, marginY)) continue;
+        view_cell_t c = {(int8_t)rx, (int8_t)ry};
+        if (put(&w, &c, sizeof(c)) < 0) break;
+        h.foodCount++;
+    }
+
+    // Udalosti: kto vošiel do výhľadu a kto z neho zmizol od minulého výrezu.
+    // Predplatné sa mení iba pre odoslané udalosti, orezané prídu v ďalšom výreze
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 0; i < state->maxSnakes; i++) {
+            int now = slot_test(visible, i);
+            int before = slot_test(sub->visible, i);
+            if (now == before || now != (pass == 0)) continue;
+            int *count = pass == 0 ? &h.enterCount : &h.leaveCount;
+            if (*count >= VIEW_MAX_EVENTS) break;
+            int16_t slot = (int16_t)i;
+            if (put(&w, &slot, sizeof(slot)) < 0) break;
+            (*count)++;
+            slot_flip(sub->visible, i);
+        }
+    }
+
+    memcpy(buf, &h, sizeof(h));
+    return w.used;
+}
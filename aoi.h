@@ -0,0 +1,44 @@
+#ifndef AOI_H
+#define AOI_H
+
+#include "shared.h"
+#include "game.h"
+
+// Area of interest: index hadíkov po blokoch sveta a výrezy pre jednotlivých klientov.
+// Index sa stavia raz za tick hry, výrez klienta prechádza iba bloky vo svojom okolí.
+
+#define AOI_CHUNK 16
+#define AOI_MAX_CHUNKS_X ((ARENA_MAX_WIDTH + AOI_CHUNK - 1) / AOI_CHUNK)
+#define AOI_MAX_CHUNKS_Y ((ARENA_MAX_HEIGHT + AOI_CHUNK - 1) / AOI_CHUNK)
+
+// Najväčšia oblasť výrezu s okrajom v políčkach (bitmapa a behy v MSG_VIEW)
+#define AOI_REGION_MAX ((VIEW_WIDTH + 2 * VIEW_MARGIN) * (VIEW_HEIGHT + 2 * VIEW_MARGIN))
+
+typedef struct AoiIndex {
+    int chunksX;
+    int chunksY;
+    // Bitová maska živých hadíkov, ktorých telo zasahuje do bloku
+    uint64_t chunkSnakes[AOI_MAX_CHUNKS_Y * AOI_MAX_CHUNKS_X][ENGINE_MASK_WORDS];
+} aoi_index_t;
+
+// Čo klient videl v minulom výreze (pre enter/leave udalosti)
+typedef struct AoiSubscription {
+    int gameId;
+    uint64_t visible[ENGINE_MASK_WORDS];
+} aoi_subscription_t;
+
+// Postaví index blokov zo živých hadíkov (volať pod zámkom hry)
+void aoi_build_index(aoi_index_t *index, const game_engine_t *state);
+
+// Zabudne predchádzajúci výhľad (nová hra alebo nové spojenie)
+void aoi_reset(aoi_subscription_t *sub);
+
+// Zakóduje MSG_VIEW payload pre hráča v slote selfSlot (-1 = divák),
+// vráti dĺžku v bajtoch (najviac cap). Hadíky idú v najkratšom kódovaní.
+int aoi_encode_view(const aoi_index_t *index, const game_engine_t *state, int selfSlot,
+                    aoi_subscription_t *sub, char *buf, int cap);
+
+// Vynúti kódovanie hadíkov vo všetkých výrezoch (benchmark), -1 = najkratšie
+void aoi_force_encoding(int encoding);
+
+#endif // AOI_H
@@ -0,0 +1,134 @@
+#define _GNU_SOURCE
+#include "balance.h"
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+
+#define COST_SMOOTHING 8    // Nová vzorka má váhu 1/8
+#define REBALANCE_GAIN 120  // Nové rozdelenie sa použije, ak je najvyťaženejšie jadro aspoň o 20 % ľahšie
+
+static atomic_int tickCostUs[MAX_PLAYERS];
+static atomic_int gameCore[MAX_PLAYERS];  // Index do cpus, -1 = bez pripnutia
+static int cpus[CPU_SETSIZE];
+static int cpuCount = 0;
+static int64_t lastRebalanceMs = 0;
+
+void balance_init(int shardIndex, int shardCount) {
+    for (int g = 0; g < MAX_PLAYERS; g++) balance_forget(g);
+
+    cpu_set_t set;
+    cpuCount = 0;
+    if (sched_getaffinity(0, sizeof(set), &set) < 0) return;
+
+    int all[CPU_SETSIZE];
+    int total = 0;
+    for (int c = 0; c < CPU_SETSIZE; c++) {
+        if (CPU_ISSET(c, &set)) all[total++] = c;
+    }
+    // Shardy si jadrá rozdelia, aby sa ich hry nepchali na tie isté
+    for (int k = 0; k < total; k++) {
+        if (shardCount <= 1 || total < shardCount || k % shardCount == shardIndex) {
+            cpus[cpuCount++] = all[k];
+        }
+    }
+}
+
+int balance_cpu_count(void) {
+    return cpuCount;
+}
+
+void balance_record_tick(int gameId, int costUs) {
+    if (costUs < 1) costUs = 1;
+    int old = atomic_load_explicit(&tickCostUs[gameId], memory_order_relaxed);
+    int next = old == 0 ? costUs : old + (costUs - old) / COST_SMOOTHING;
+    atomic_store_explicit(&tickCostUs[gameId], next, memory_order_relaxed);
+}
+
+int balance_tick_cost(int gameId) {
+    return atomic_load_explicit(&tickCostUs[gameId], memory_order_relaxed);
+}
+
+int balance_core(int gameId) {
+    int core = atomic_load_explicit(&gameCore[gameId], memory_order_relaxed);
+    return core >= 0 && core < cpuCount ? cpus[core] : -1;
+}
+
+void balance_apply(int gameId, int *appliedCore) {
+    int core = atomic_load_explicit(&gameCore[gameId], memory_order_relaxed);
+    if (core == *appliedCore) return;
+    *appliedCore = core;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (core >= 0 && core < cpuCount) {
+        CPU_SET(cpus[core], &set);
+    } else {
+        for (int c = 0; c < cpuCount; c++) CPU_SET(cpus[c], &set);
+    }
+    if (cpuCount > 0) pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+void balance_forget(int gameId) {
+    atomic_store_explicit(&tickCostUs[gameId], 0, memory_order_relaxed);
+    atomic_store_explicit(&gameCore[gameId], -1, memory_order_relaxed);
+}
+
+void balance_rebalance(const int *running, int64_t nowMs) {
+    if (cpuCount < 2 || nowMs - lastRebalanceMs < BALANCE_INTERVAL_MS) return;
+    lastRebalanceMs = nowMs;
+
+    // Hry zoradené od najdrahšej (nenameraná hra stojí 1 µs)
+    int order[MAX_PLAYERS];
+    int cost[MAX_PLAYERS];
+    int n = 0;
+    for (int g = 0; g < MAX_PLAYERS; g++) {
+        if (!running[g]) continue;
+        cost[g] = balance_tick_cost(g);
+        if (cost[g] < 1) cost[g] = 1;
+        int k = n++;
+        while (k > 0 && cost[order[k - 1]] < cost[g]) {
+            order[k] = order[k - 1];
+            k--;
+        }
+        order[k] = g;
+    }
+    if (n == 0) return;
+
+    static long load[CPU_SETSIZE];
+    static long currentLoad[CPU_SETSIZE];
+    int assign[MAX_PLAYERS];
+    int unpinned = 0;
+    for (int c = 0; c < cpuCount; c++) {
+        load[c] = 0;
+        currentLoad[c] = 0;
+    }
+    for (int k = 0; k < n; k++) {
+        int g = order[k];
+        int best = 0;
+        for (int c = 1; c < cpuCount; c++) {
+            if (load[c] < load[best]) best = c;
+        }
+        assign[g] = best;
+        load[best] += cost[g];
+
+        int core = atomic_load_explicit(&gameCore[g], memory_order_relaxed);
+        if (core < 0 || core >= cpuCount) {
+            unpinned = 1;
+        } else {
+            currentLoad[core] += cost[g];
+        }
+    }
+
+    long newMax = 0, currentMax = 0;
+    for (int c = 0; c < cpuCount; c++) {
+        if (load[c] > newMax) newMax = load[c];
+        if (currentLoad[c] > currentMax) currentMax = currentLoad[c];
+    }
+    // Kvôli šumu v meraní sa pripnuté hry presúvajú iba pri citeľnom zlepšení
+    if (!unpinned && currentMax * 100 <= newMax * REBALANCE_GAIN) return;
+
+    for (int k = 0; k < n; k++) {
+        atomic_store_explicit(&gameCore[order[k]], assign[order[k]], memory_order_relaxed);
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef BALANCE_H
+#define BALANCE_H
+
+#include <stdint.h>
+#include "shared.h"
+
+// Rozdelenie herných vlákien na jadrá podľa nameraných nákladov ticku.
+// Herné vlákno hlási cenu každého ticku a samo si nastaví pridelené jadro,
+// hlavné vlákno raz za BALANCE_INTERVAL_MS prepočíta rozdelenie (LPT:
+// najdrahšia hra na najmenej zaťažené jadro).
+
+#define BALANCE_INTERVAL_MS 2000
+
+// Zistí dostupné jadrá; pri shardingu dostane každý shard vlastnú časť
+void balance_init(int shardIndex, int shardCount);
+
+// Počet jadier, medzi ktoré sa hry rozdeľujú
+int balance_cpu_count(void);
+
+// Cena jedného ticku hry v µs (vyhladená), volá herné vlákno
+void balance_record_tick(int gameId, int costUs);
+
+// Vyhladená cena ticku hry v µs, 0 ak ešte nebola nameraná
+int balance_tick_cost(int gameId);
+
+// Jadro pridelené hre, -1 ak nie je pripnutá
+int balance_core(int gameId);
+
+// Herné vlákno pripne samo seba na pridelené jadro, ak sa zmenilo od *appliedCore
+void balance_apply(int gameId, int *appliedCore);
+
+// Hra skončila, jej meranie sa zabudne
+void balance_forget(int gameId);
+
+// Prepočíta rozdelenie bežiacich hier (running[g] != 0), volá hlavné vlákno
+void balance_rebalance(const int *running, int64_t nowMs);
+
+#endif // BALANCE_H
@@ -0,0 +1,434 @@
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/select.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <time.h>
+
+#include "shared.h"
+#include "net.h"
+#include "game.h"
+#include "aoi.h"
+
+// Záťažový test servera: klienti sa rozdelia do hier, posielajú vstupy daným
+// tempom a počítajú prijaté výrezy. S -p sa zmeria aj CPU čas a prepnutia
+// kontextu procesu servera (porovnanie select a io_uring backendu, -u).
+// S -k sa bez servera porovná špecializovaný variant ticku s generickým,
+// s -v veľkosti výrezov v jednotlivých kódovaniach hadíkov.
+
+#define BENCH_MAX_CLIENTS MAX_PLAYERS
+
+typedef struct BenchClient {
+    int fd;
+    int gameId;
+    int finished;        // Hra skončila
+    long frames;
+    long bytes;
+    msg_reader_t reader;
+} bench_client_t;
+
+static bench_client_t benchClients[BENCH_MAX_CLIENTS];
+static char payload[VIEW_MAX_BYTES];
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static int send_action(bench_client_t *c, int playerId, action_t action, direction_t dir) {
+    client_input_t in;
+    memset(&in, 0, sizeof(in));
+    in.playerId = playerId;
+    in.gameId = c->gameId;
+    in.action = action;
+    in.direction = dir;
+    return send(c->fd, &in, sizeof(in), MSG_NOSIGNAL) == sizeof(in) ? 0 : -1;
+}
+
+// Počká na prvý výrez a vráti gameId, -1 pri chybe
+static int wait_first_view(bench_client_t *c) {
+    for (int i = 0; i < 200; i++) {
+        msg_header_t hdr;
+        int ret = net_recv_msg(c->fd, &c->reader, &hdr, payload, sizeof(payload));
+        if (ret < 0) return -1;
+        if (ret == 0) {
+            usleep(10000);
+            continue;
+        }
+        if (hdr.type == MSG_VIEW && hdr.length >= (int)sizeof(view_header_t)) {
+            view_header_t h;
+            memcpy(&h, payload, sizeof(h));
+            return h.gameId;
+        }
+        if (hdr.type == MSG_BUSY && hdr.length >= (int)sizeof(busy_t)) {
+            busy_t busy;
+            memcpy(&busy, payload, sizeof(busy));
+            fprintf(stderr, "Server busy (reason %d), retry after %d ms\n", busy.reason, busy.retryAfterMs);
+            return -1;
+        }
+    }
+    return -1;
+}
+
+static int connect_client(bench_client_t *c) {
+    memset(c, 0, sizeof(*c));
+    c->fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (c->fd < 0) return -1;
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(PORT);
+    addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+    if (connect(c->fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        close(c->fd);
+        return -1;
+    }
+    net_reader_init(&c->reader);
+    c->gameId = -1;
+    return 0;
+}
+
+// CPU čas procesu (utime + stime v tikoch), vráti 0 alebo -1
+static int read_cpu_ticks(int pid, long *cpuTicks) {
+    char path[64];
+    char buf[1024];
+    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+    size_t n = fread(buf, 1, sizeof(buf) - 1, f);
+    fclose(f);
+    buf[n] = '\0';
+    // Polia za názvom procesu (ten môže obsahovať medzery)
+    char *p = strrchr(buf, ')');
+    if (!p) return -1;
+    long utime = 0, stime = 0;
+    if (sscanf(p + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %ld %ld", &utime, &stime) != 2) {
+        return -1;
+    }
+    *cpuTicks = utime + stime;
+    return 0;
+}
+
+// Súčet prepnutí kontextu všetkých vlákien procesu (každé zobudenie slučky/vlákna)
+static long read_ctx_switches(int pid) {
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/task", pid);
+    char cmd[128];
+    snprintf(cmd, sizeof(cmd), "cat %s/*/status 2>/dev/null", path);
+    FILE *f = popen(cmd, "r");
+    if (!f) return -1;
+    long total = 0;
+    char line[128];
+    while (fgets(line, sizeof(line), f)) {
+        long v;
+        if (sscanf(line, "voluntary_ctxt_switches: %ld", &v) == 1) total += v;
+        if (sscanf(line, "nonvoluntary_ctxt_switches: %ld", &v) == 1) total += v;
+    }
+    pclose(f);
+    return total;
+}
+
+// Predvoľby arén pre -k (kapacita hadíkov ako na serveri: plocha / 80, 10 až 256)
+typedef struct TickPreset {
+    const char *name;
+    int width;
+    int height;
+    int snakes;
+} tick_preset_t;
+
+#define TICK_BENCH_REPEATS 5  // Varianty sa striedajú, berie sa najrýchlejšie opakovanie
+
+static const tick_preset_t tickPresets[] = {
+    {"classic", WORLD_WIDTH, WORLD_HEIGHT, MAX_PLAYERS},
+    {"50x30", 50, 30, 18},
+    {"32x32", 32, 32, 12},
+    {"64x64", 64, 64, 51},
+    {"128x128", 128, 128, 204},
+    {"200x120", 200, 120, 256},
+    {"256x256", 256, 256, 256},
+};
+
+// Náhodné zmeny smeru pred tickom; mŕtvi hráči sa hneď vrátia
+static void random_inputs(game_engine_t *state) {
+    for (int i = 0; i < state->maxSnakes; i++) {
+        int id = state->playerId[i];
+        if (id < 0) continue;
+        if (!game_player_alive(state, i)) {
+            game_remove_player(state, i, 1);
+            game_add_player(state, id);
+        } else if (rand() % 4 == 0) {
+            client_input_t in;
+            memset(&in, 0, sizeof(in));
+            in.action = ACTION_MOVE;
+            in.direction = (direction_t)(rand() % 4);
+            game_process_input(state, id, &in);
+        }
+    }
+}
+
+// Odsimuluje ticks tickov s náhodnými zmenami smeru.
+// Meria sa iba game_tick, vráti ns/tick a do *checksum odtlačok konečného stavu.
+static double run_tick_kernel(game_engine_t *state, const tick_preset_t *p, int generic, int ticks,
+                              unsigned *checksum) {
+    srand(42);
+    game_init(state);
+    game_configure(state, p->width, p->height, p->snakes);
+    if (generic) game_set_tick_kernel(state, TICK_KERNEL_GENERIC);
+    for (int k = 0; k < p->snakes; k++) game_add_player(state, 1 + k);
+
+    double total = 0;
+    for (int t = 0; t < ticks; t++) {
+        random_inputs(state);
+        double t0 = now_sec();
+        game_tick(state);
+        total += now_sec() - t0;
+    }
+
+    unsigned h = 2166136261u;
+    for (int c = 0; c < state->width * state->height; c++) h = (h ^ state->cells[c]) * 16777619u;
+    for (int i = 0; i < state->maxSnakes; i++) h = (h ^ (unsigned)state->score[i]) * 16777619u;
+    *checksum = h;
+    return total * 1e9 / ticks;
+}
+
+// Réžia jedného merania now_sec, odčíta sa od času ticku
+static double timer_overhead_ns(void) {
+    double t0 = now_sec();
+    for (int i = 0; i < 100000; i++) now_sec();
+    return (now_sec() - t0) * 1e9 / 100000;
+}
+
+// Porovná variant, ktorý vyberie game_configure, s TICK_KERNEL_GENERIC
+static int run_tick_bench(int ticks) {
+    game_engine_t *state = malloc(sizeof(*state));
+    if (!state) return 1;
+    int mismatches = 0;
+    double overhead = timer_overhead_ns();
+    printf("%-8s %-11s %12s %12s %8s\n", "Aréna", "Variant", "generic", "špecial.", "Zrýchl.");
+    for (size_t k = 0; k < sizeof(tickPresets) / sizeof(tickPresets[0]); k++) {
+        const tick_preset_t *p = &tickPresets[k];
+        unsigned sumGeneric, sumSpecial;
+        double generic = 1e18, special = 1e18;
+        for (int r = 0; r < TICK_BENCH_REPEATS; r++) {
+            double g = run_tick_kernel(state, p, 1, ticks, &sumGeneric) - overhead;
+            double sp = run_tick_kernel(state, p, 0, ticks, &sumSpecial) - overhead;
+            if (g < generic) generic = g;
+            if (sp < special) special = sp;
+        }
+        tick_kernel_t kernel = (tick_kernel_t)state->tickKernel;
+        printf("%-8s %-11s %9.0f ns %9.0f ns %7.2fx%s\n", p->name, game_tick_kernel_name(kernel), generic,
+               special, generic / special, sumGeneric == sumSpecial ? "" : "  ROZDIELNY STAV");
+        if (sumGeneric != sumSpecial) mismatches++;
+    }
+    free(state);
+    return mismatches ? 1 : 0;
+}
+
+static const tick_preset_t viewPresets[] = {
+    {"classic", WORLD_WIDTH, WORLD_HEIGHT, MAX_PLAYERS},
+    {"40x20/64", WORLD_WIDTH, WORLD_HEIGHT, 64},
+    {"64x64", 64, 64, 51},
+    {"64x64/160", 64, 64, 160},
+    {"256x256", 256, 256, 256},
+};
+
+static const char *encodingNames[VIEW_ENC_COUNT] = {"list", "bitmap", "rle"};
+
+// Priemerná veľkosť výrezov (hráč v slote 0 aj divák) v každom kódovaní
+// a vo výbere servera; preťažené arény dávajú husté výrezy
+static int run_view_bench(int ticks) {
+    game_engine_t *state = malloc(sizeof(*state));
+    aoi_index_t *index = malloc(sizeof(*index));
+    if (!state || !index) return 1;
+    static char buf[VIEW_MAX_BYTES];
+    printf("%-10s %8s %8s %8s %8s  %s\n", "Aréna", "list", "bitmap", "rle", "výber", "B/výrez, výbery");
+    for (size_t k = 0; k < sizeof(viewPresets) / sizeof(viewPresets[0]); k++) {
+        const tick_preset_t *p = &viewPresets[k];
+        srand(42);
+        game_init(state);
+        game_configure(state, p->width, p->height, p->snakes);
+        for (int i = 0; i < p->snakes; i++) game_add_player(state, 1 + i);
+
+        long bytes[VIEW_ENC_COUNT + 1] = {0};
+        long picked[VIEW_ENC_COUNT] = {0};
+        long views = 0;
+        for (int t = 0; t < ticks; t++) {
+            random_inputs(state);
+            game_tick(state);
+            aoi_build_index(index, state);
+            for (int self = -1; self <= 0; self++) {
+                for (int e = -1; e < VIEW_ENC_COUNT; e++) {
+                    aoi_subscription_t sub;
+                    aoi_reset(&sub);
+                    aoi_force_encoding(e);
+                    int length = aoi_encode_view(index, state, self, &sub, buf, VIEW_MAX_BYTES);
+                    if (e >= 0) {
+                        bytes[e] += length;
+                        continue;
+                    }
+                    view_header_t h;
+                    memcpy(&h, buf, sizeof(h));
+                    bytes[VIEW_ENC_COUNT] += length;
+                    picked[h.encoding]++;
+                }
+                views++;
+            }
+        }
+        aoi_force_encoding(-1);
+        printf("%-10s %8ld %8ld %8ld %8ld ", p->name, bytes[0] / views, bytes[1] / views, bytes[2] / views,
+               bytes[VIEW_ENC_COUNT] / views);
+        for (int e = 0; e < VIEW_ENC_COUNT; e++) printf(" %s %ld%%", encodingNames[e], picked[e] * 100 / views);
+        printf("\n");
+    }
+    free(index);
+    free(state);
+    return 0;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [-c clients] [-g games] [-d seconds] [-r inputs/s] [-p server_pid]\n", prog);
+    fprintf(stderr, "       %s -k ticks   (varianty ticku enginu bez servera; zmysel má s CFLAGS=-O2)\n", prog);
+    fprintf(stderr, "       %s -v ticks   (veľkosti výrezov podľa kódovania hadíkov)\n", prog);
+}
+
+int main(int argc, char **argv) {
+    int clientCount = 8;
+    int gameCount = 2;
+    int duration = 10;
+    int rate = 20;
+    int serverPid = 0;
+    int tickBench = 0;
+    int viewBench = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "c:g:d:r:p:k:v:h")) != -1) {
+        switch (opt) {
+            case 'c': clientCount = atoi(optarg); break;
+            case 'g': gameCount = atoi(optarg); break;
+            case 'd': duration = atoi(optarg); break;
+            case 'r': rate = atoi(optarg); break;
+            case 'p': serverPid = atoi(optarg); break;
+            case 'k': tickBench = atoi(optarg); break;
+            case 'v': viewBench = atoi(optarg); break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+    if (tickBench > 0) {
+        return run_tick_bench(tickBench);
+    }
+    if (viewBench > 0) {
+        return run_view_bench(viewBench);
+    }
+    if (clientCount < 1 || clientCount > BENCH_MAX_CLIENTS || gameCount < 1 || gameCount > clientCount ||
+        duration < 1 || rate < 1) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    // Prví gameCount klienti vytvoria hry, ostatní sa k nim pridajú
+    int gameIds[BENCH_MAX_CLIENTS];
+    for (int k = 0; k < clientCount; k++) {
+        bench_client_t *c = &benchClients[k];
+        if (connect_client(c) < 0) {
+            perror("connect failed");
+            return 1;
+        }
+        if (k < gameCount) {
+            send_action(c, 1000 + k, ACTION_CREATE_GAME, DIR_NONE);
+        } else {
+            c->gameId = gameIds[k % gameCount];
+            send_action(c, 1000 + k, ACTION_JOIN_GAME, DIR_NONE);
+        }
+        c->gameId = wait_first_view(c);
+        if (c->gameId < 0) {
+            fprintf(stderr, "Client %d got no view\n", k);
+            return 1;
+        }
+        if (k < gameCount) gameIds[k] = c->gameId;
+        fcntl(c->fd, F_SETFL, fcntl(c->fd, F_GETFL, 0) | O_NONBLOCK);
+    }
+
+    long cpuStart = 0, cpuEnd = 0;
+    long ctxStart = serverPid > 0 ? read_ctx_switches(serverPid) : 0;
+    if (serverPid > 0 && read_cpu_ticks(serverPid, &cpuStart) < 0) {
+        fprintf(stderr, "Cannot read /proc/%d\n", serverPid);
+        serverPid = 0;
+    }
+
+    double start = now_sec();
+    double nextInput = start;
+    double interval = 1.0 / rate;
+    long inputs = 0;
+    while (now_sec() - start < duration) {
+        double t = now_sec();
+        if (t >= nextInput) {
+            // Vstup, ktorý smer nemení (hadík ide stále doprava), iba zaťaží recv cestu
+            for (int k = 0; k < clientCount; k++) {
+                if (!benchClients[k].finished) {
+                    send_action(&benchClients[k], 1000 + k, ACTION_MOVE, DIR_RIGHT);
+                    inputs++;
+                }
+            }
+            nextInput += interval;
+        }
+
+        fd_set rfds;
+        FD_ZERO(&rfds);
+        int maxfd = -1;
+        for (int k = 0; k < clientCount; k++) {
+            FD_SET(benchClients[k].fd, &rfds);
+            if (benchClients[k].fd > maxfd) maxfd = benchClients[k].fd;
+        }
+        double wait = nextInput - now_sec();
+        if (wait < 0) wait = 0;
+        struct timeval tv;
+        tv.tv_sec = 0;
+        tv.tv_usec = (long)(wait * 1e6);
+        if (select(maxfd + 1, &rfds, NULL, NULL, &tv) <= 0) continue;
+
+        for (int k = 0; k < clientCount; k++) {
+            bench_client_t *c = &benchClients[k];
+            if (!FD_ISSET(c->fd, &rfds)) continue;
+            msg_header_t hdr;
+            int ret;
+            while ((ret = net_recv_msg(c->fd, &c->reader, &hdr, payload, sizeof(payload))) == 1) {
+                if (hdr.type != MSG_VIEW) continue;
+                c->frames++;
+                c->bytes += hdr.length;
+                view_header_t h;
+                memcpy(&h, payload, sizeof(h));
+                if (!h.gameRunning) c->finished = 1;
+            }
+            if (ret < 0) c->finished = 1;
+        }
+    }
+    double elapsed = now_sec() - start;
+    long ctxEnd = serverPid > 0 ? read_ctx_switches(serverPid) : 0;
+    if (serverPid > 0) read_cpu_ticks(serverPid, &cpuEnd);
+
+    long frames = 0, bytes = 0;
+    int finished = 0;
+    for (int k = 0; k < clientCount; k++) {
+        frames += benchClients[k].frames;
+        bytes += benchClients[k].bytes;
+        finished += benchClients[k].finished;
+        close(benchClients[k].fd);
+    }
+    printf("clients %d, games %d, %.1f s\n", clientCount, gameCount, elapsed);
+    printf("inputs sent   %ld (%.0f/s)\n", inputs, inputs / elapsed);
+    printf("frames recv   %ld (%.1f/s), %.1f KB/s, finished games on %d clients\n",
+           frames, frames / elapsed, bytes / elapsed / 1024.0, finished);
+    if (serverPid > 0) {
+        double cpuMs = (double)(cpuEnd - cpuStart) * 1000.0 / (double)sysconf(_SC_CLK_TCK);
+        printf("server CPU    %.0f ms (%.2f ms per 1000 inputs)\n", cpuMs, inputs ? cpuMs * 1000.0 / inputs : 0.0);
+        printf("server ctx switches %ld (%.2f per input)\n", ctxEnd - ctxStart,
+               inputs ? (double)(ctxEnd - ctxStart) / inputs : 0.0);
+    }
+    return 0;
+}
@@ -0,0 +1,353 @@
+#include "bot.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define DIST_INF 0xFFFFu
+
+// Trieda políčka pre hľadanie cesty
+#define CLASS_FREE 0
+#define CLASS_FOOD 1
+#define CLASS_BLOCKED 2
+
+// Pri zmene väčšej časti mriežky je lacnejšie pole zostaviť celé
+#define FULL_REBUILD_DIVISOR 4
+
+typedef struct FieldItem {
+    int cell;
+    int level;
+} field_item_t;
+
+// Pole vzdialeností k najbližšiemu ovociu, spoločné pre všetkých botov hry
+typedef struct BotField {
+    int width;
+    int height;
+    int area;
+    int valid;                // 0 = treba zostaviť celé
+    int work;                 // Spracované políčka pri poslednej oprave
+    uint32_t stamp;           // Číslo ticku pre claim
+    uint8_t *prev;            // Mriežka, z ktorej bolo pole naposledy zostavené
+    uint16_t *dist;           // DIST_INF = prekážka alebo nedosiahnuteľné
+    uint32_t *claim;          // Políčko si v ticku stamp už vybral iný bot
+    int *changed;
+    int *invalid;
+    field_item_t *seeds;
+    field_item_t *queue;
+    int queueCap;
+} bot_field_t;
+
+static const int dirOpposite[] = {DIR_DOWN, DIR_UP, DIR_RIGHT, DIR_LEFT};
+
+static inline int cell_class(uint8_t c) {
+    if (c & CELL_BODY_MASK) return CLASS_BLOCKED;
+    return (c & CELL_FOOD) ? CLASS_FOOD : CLASS_FREE;
+}
+
+// Susedia políčka v poradí smerov (DIR_UP, DIR_DOWN, DIR_LEFT, DIR_RIGHT), s wraparoundom
+static inline void neighbors(const bot_field_t *f, int c, int out[4]) {
+    int x = c % f->width;
+    out[DIR_UP] = c >= f->width ? c - f->width : c + f->area - f->width;
+    out[DIR_DOWN] = c + f->width < f->area ? c + f->width : c + f->width - f->area;
+    out[DIR_LEFT] = x > 0 ? c - 1 : c + f->width - 1;
+    out[DIR_RIGHT] = x < f->width - 1 ? c + 1 : c - x;
+}
+
+static int compare_items(const void *a, const void *b) {
+    const field_item_t *x = a;
+    const field_item_t *y = b;
+    return x->level - y->level;
+}
+
+static void field_free(bot_field_t *f) {
+    if (!f) return;
+    free(f->prev);
+    free(f->dist);
+    free(f->claim);
+    free(f->changed);
+    free(f->invalid);
+    free(f->seeds);
+    free(f->queue);
+    free(f);
+}
+
+static bot_field_t *field_alloc(int width, int height) {
+    bot_field_t *f = calloc(1, sizeof(*f));
+    if (!f) return NULL;
+    f->width = width;
+    f->height = height;
+    f->area = width * height;
+    f->queueCap = 4 * f->area + 16;
+    f->prev = malloc((size_t)f->area);
+    f->dist = malloc((size_t)f->area * sizeof(*f->dist));
+    f->claim = calloc((size_t)f->area, sizeof(*f->claim));
+    f->changed = malloc((size_t)f->area * sizeof(*f->changed));
+    f->invalid = malloc((size_t)f->area * sizeof(*f->invalid));
+    f->seeds = malloc((size_t)f->area * 2 * sizeof(*f->seeds));
+    f->queue = malloc((size_t)f->queueCap * sizeof(*f->queue));
+    if (!f->prev || !f->dist || !f->claim || !f->changed || !f->invalid || !f->seeds || !f->queue) {
+        field_free(f);
+        return NULL;
+    }
+    return f;
+}
+
+// Multi-source BFS od všetkého ovocia cez celú mriežku
+static void field_build(bot_field_t *f, const uint8_t *cells) {
+    int head = 0, tail = 0;
+    memcpy(f->prev, cells, (size_t)f->area);
+    for (int c = 0; c < f->area; c++) {
+        if (cell_class(cells[c]) == CLASS_FOOD) {
+            f->dist[c] = 0;
+            f->queue[tail++] = (field_item_t){c, 0};
+        } else {
+            f->dist[c] = DIST_INF;
+        }
+    }
+    while (head < tail) {
+        field_item_t it = f->queue[head++];
+        int nb[4];
+        neighbors(f, it.cell, nb);
+        for (int d = 0; d < 4; d++) {
+            int y = nb[d];
+            if (f->dist[y] != DIST_INF || cell_class(cells[y]) == CLASS_BLOCKED) continue;
+            f->dist[y] = (uint16_t)(it.level + 1);
+            f->queue[tail++] = (field_item_t){y, it.level + 1};
+        }
+    }
+    f->work = f->area;
+    f->valid = 1;
+}
+
+// Políčka, ktorých trieda sa od posledného zostavenia zmenila; porovnáva po 8 bajtoch
+static int field_diff(bot_field_t *f, const uint8_t *cells) {
+    int n = 0;
+    int c = 0;
+    for (; c + 8 <= f->area; c += 8) {
+        uint64_t a, b;
+        memcpy(&a, f->prev + c, 8);
+        memcpy(&b, cells + c, 8);
+        if (a == b) continue;
+        for (int k = c; k < c + 8; k++) {
+            if (cell_class(f->prev[k]) != cell_class(cells[k])) f->changed[n++] = k;
+        }
+    }
+    for (; c < f->area; c++) {
+        if (cell_class(f->prev[c]) != cell_class(cells[c])) f->changed[n++] = c;
+    }
+    return n;
+}
+
+// Spracuje položky v poradí úrovní: zoradené seeds zlúčené s FIFO frontom,
+// do ktorého sa pridáva vždy úroveň o 1 vyššia. raise=1 zneplatňuje
+// políčka bez opory, raise=0 šíri skrátené vzdialenosti. Vráti počet
+// zneplatnených políčok alebo -1 pri pretečení frontu.
+static int field_sweep(bot_field_t *f, const uint8_t *cells, int seedCount, int raise) {
+    int si = 0, head = 0, tail = 0, invalid = 0;
+    qsort(f->seeds, (size_t)seedCount, sizeof(*f->seeds), compare_items);
+    while (si < seedCount || head < tail) {
+        field_item_t it;
+        if (head < tail && (si >= seedCount || f->queue[head].level <= f->seeds[si].level)) {
+            it = f->queue[head++];
+        } else {
+            it = f->seeds[si++];
+        }
+        if (f->dist[it.cell] != it.level) continue;  // Medzitým zmenené
+        f->work++;
+
+        int nb[4];
+        neighbors(f, it.cell, nb);
+        if (raise) {
+            int cls = cell_class(cells[it.cell]);
+            if (cls == CLASS_FOOD) continue;
+            if (cls == CLASS_FREE && it.level > 0) {
+                // Opora = sused o úroveň nižšie; nižšie úrovne sú už spracované
+                int supported = 0;
+                for (int d = 0; d < 4 && !supported; d++) {
+                    supported = f->dist[nb[d]] == it.level - 1;
+                }
+                if (supported) continue;
+            }
+            f->dist[it.cell] = DIST_INF;
+            f->invalid[invalid++] = it.cell;
+            for (int d = 0; d < 4; d++) {
+                if (f->dist[nb[d]] != it.level + 1) continue;
+                if (tail == f->queueCap) return -1;
+                f->queue[tail++] = (field_item_t){nb[d], it.level + 1};
+            }
+        } else {
+            for (int d = 0; d < 4; d++) {
+                int y = nb[d];
+                if (f->dist[y] <= it.level + 1 || cell_class(cells[y]) == CLASS_BLOCKED) continue;
+                if (tail == f->queueCap) return -1;
+                f->dist[y] = (uint16_t)(it.level + 1);
+                f->queue[tail++] = (field_item_t){y, it.level + 1};
+            }
+        }
+    }
+    return invalid;
+}
+
+// Najmenšia vzdialenosť, ktorú políčko môže mať podľa susedov
+static int field_candidate(const bot_field_t *f, const uint8_t *cells, int c) {
+    int cls = cell_class(cells[c]);
+    if (cls == CLASS_BLOCKED) return DIST_INF;
+    if (cls == CLASS_FOOD) return 0;
+    int nb[4];
+    int best = DIST_INF;
+    neighbors(f, c, nb);
+    for (int d = 0; d < 4; d++) {
+        if (f->dist[nb[d]] < DIST_INF && f->dist[nb[d]] + 1 < best) best = f->dist[nb[d]] + 1;
+    }
+    return best;
+}
+
+// Oprava poľa po zmene mriežky (dynamický BFS s jednotkovými hranami):
+// 1. zväčšenie: políčka, ktoré stratili ovocie alebo sa stali prekážkou,
+//    a všetko, čo sa o ne opieralo, sa zneplatní,
+// 2. zmenšenie: zneplatnené a uvoľnené políčka dostanú odhad od susedov
+//    a kratšie vzdialenosti sa rozšíria ďalej.
+static void field_update(bot_field_t *f, const uint8_t *cells) {
+    if (!f->valid) {
+        field_build(f, cells);
+        return;
+    }
+    f->work = 0;
+    int changed = field_diff(f, cells);
+    if (changed == 0) return;
+    if (changed > f->area / FULL_REBUILD_DIVISOR) {
+        field_build(f, cells);
+        return;
+    }
+
+    int seeds = 0;
+    for (int k = 0; k < changed; k++) {
+        int c = f->changed[k];
+        if (f->dist[c] == DIST_INF) continue;
+        int cls = cell_class(cells[c]);
+        if (cls == CLASS_BLOCKED || (cell_class(f->prev[c]) == CLASS_FOOD && cls != CLASS_FOOD)) {
+            f->seeds[seeds++] = (field_item_t){c, f->dist[c]};
+        }
+    }
+    int invalid = field_sweep(f, cells, seeds, 1);
+    if (invalid < 0) {
+        field_build(f, cells);
+        return;
+    }
+
+    seeds = 0;
+    for (int k = 0; k < invalid + changed; k++) {
+        int c = k < invalid ? f->invalid[k] : f->changed[k - invalid];
+        int cand = field_candidate(f, cells, c);
+        if (cand >= f->dist[c]) continue;
+        f->dist[c] = (uint16_t)cand;
+        f->seeds[seeds++] = (field_item_t){c, cand};
+    }
+    if (field_sweep(f, cells, seeds, 0) < 0) {
+        field_build(f, cells);
+        return;
+    }
+    memcpy(f->prev, cells, (size_t)f->area);
+}
+
+int bot_attach(bot_group_t *group, const game_engine_t *state, int count, int persistent) {
+    bot_detach(group);
+    if (count > state->maxSnakes) count = state->maxSnakes;
+    if (count <= 0) return 0;
+
+    group->field = field_alloc(state->width, state->height);
+    if (!group->field) return -1;
+    group->count = count;
+    group->persistent = persistent;
+    for (int k = 0; k < ARENA_MAX_SNAKES; k++) group->slot[k] = -1;
+    return 0;
+}
+
+void bot_detach(bot_group_t *group) {
+    field_free(group->field);
+    memset(group, 0, sizeof(*group));
+}
+
+int bot_field_work(const bot_group_t *group) {
+    return group->field ? group->field->work : 0;
+}
+
+// Slot k-teho bota alebo -1; po obnove z handoveru ho treba nájsť podľa playerId
+static int bot_slot(bot_group_t *group, const game_engine_t *state, int k) {
+    int id = BOT_PLAYER_ID(k);
+    int s = group->slot[k];
+    if (s >= 0 && s < state->maxSnakes && state->playerId[s] == id) return s;
+    group->slot[k] = -1;
+    for (int i = 0; i < state->maxSnakes; i++) {
+        if (state->playerId[i] == id) return group->slot[k] = i;
+    }
+    return -1;
+}
+
+// Vyberie smer k najbližšiemu ovociu; pri zhode ostane pri aktuálnom smere
+static void bot_steer(bot_field_t *f, game_engine_t *state, int k, int s) {
+    int head = state->headY[s] * f->width + state->headX[s];
+    direction_t cur = state->direction[s];
+    int nb[4];
+    neighbors(f, head, nb);
+
+    int best = -1;
+    long bestScore = 0;
+    for (int i = 0; i < 4; i++) {
+        int d = (cur + i) % 4;  // Aktuálny smer ako prvý
+        if (cur < 4 && d == dirOpposite[cur]) continue;
+        int n = nb[d];
+        if (cell_class(state->cells[n]) == CLASS_BLOCKED) continue;
+        // Políčko vybraté iným botom až nakoniec (zrážka hlavami zabije oboch)
+        long score = (long)f->dist[n] + (f->claim[n] == f->stamp ? (long)DIST_INF + 1 : 0);
+        if (best < 0 || score < bestScore) {
+            best = d;
+            bestScore = score;
+        }
+    }
+    if (best < 0) return;  // Všade prekážka
+    f->claim[nb[best]] = f->stamp;
+    if ((direction_t)best == cur) return;
+
+    client_input_t input = {0};
+    input.playerId = BOT_PLAYER_ID(k);
+    input.gameId = state->gameId;
+    input.action = ACTION_MOVE;
+    input.direction = (direction_t)best;
+    game_process_input(state, input.playerId, &input);
+}
+
+int bot_think(bot_group_t *group, game_engine_t *state) {
+    bot_field_t *f = group->field;
+    if (!f || group->count == 0) return 0;
+
+    int humans = 0;
+    for (int i = 0; i < state->maxSnakes; i++) {
+        if (state->playerId[i] >= 0 && game_player_alive(state, i)) humans++;
+    }
+    group->idleTicks = humans > 0 ? 0 : group->idleTicks + 1;
+    int stay = group->persistent || group->idleTicks <= BOT_GRACE_TICKS;
+
+    // Mŕtvych botov uvoľni a (kým v hre niekto je) vráť na náhodné miesto
+    for (int k = 0; k < group->count; k++) {
+        int s = bot_slot(group, state, k);
+        if (s >= 0 && (!stay || !game_player_alive(state, s))) {
+            game_remove_player(state, s, 1);
+            s = group->slot[k] = -1;
+        }
+        if (s < 0 && stay) {
+            s = game_add_player(state, BOT_PLAYER_ID(k));
+            group->slot[k] = s >= 0 ? s : -1;
+        }
+    }
+    if (!stay) return 0;
+
+    field_update(f, state->cells);
+    f->stamp++;
+    int alive = 0;
+    for (int k = 0; k < group->count; k++) {
+        int s = group->slot[k];
+        if (s < 0 || !game_player_alive(state, s)) continue;
+        bot_steer(f, state, k, s);
+        alive++;
+    }
+    return alive;
+}
@@ -0,0 +1,42 @@
+#ifndef BOT_H
+#define BOT_H
+
+#include "game.h"
+
+// Boty hostené serverom: obsadzujú bežné sloty hadíkov a smer volia
+// v hernom vlákne tesne pred game_tick, bez socketov. Cestu k ovociu
+// hľadajú v spoločnom poli vzdialeností (BFS od všetkého ovocia cez
+// voľné políčka s wraparoundom). Pole sa po ticku iba opraví okolo
+// políčok, ktoré sa zmenili, takže cena nerastie s počtom botov.
+
+// Boty majú záporné playerId (-1 je voľný slot)
+#define BOT_PLAYER_ID(k) (-2 - (k))
+#define IS_BOT_PLAYER(id) ((id) <= -2)
+
+// Bez ľudského hráča boty ešte toľkoto tickov čakajú, potom odídu a hra skončí
+#define BOT_GRACE_TICKS 4
+
+struct BotField;
+
+typedef struct BotGroup {
+    int count;                        // Počet botov v hre (0 = hra bez botov)
+    int persistent;                   // 1 = hra beží aj bez ľudí (záťažová aréna)
+    int idleTicks;                    // Ticky bez ľudského hráča
+    int slot[ARENA_MAX_SNAKES];       // Posledný známy slot k-teho bota, -1 = nie je v hre
+    struct BotField *field;
+} bot_group_t;
+
+// Pripojí k hre count botov (obmedzené kapacitou arény), vráti 0 alebo -1
+int bot_attach(bot_group_t *group, const game_engine_t *state, int count, int persistent);
+
+// Uvoľní pole vzdialeností; boty v hre ostanú ako obyčajné hadíky
+void bot_detach(bot_group_t *group);
+
+// Pred tickom: oživí mŕtvych botov, opraví pole vzdialeností a nastaví
+// botom smer. Volá sa pod zámkom hry, vráti počet živých botov.
+int bot_think(bot_group_t *group, game_engine_t *state);
+
+// Počet políčok prepočítaných pri poslednej oprave poľa (pre štatistiky)
+int bot_field_work(const bot_group_t *group);
+
+#endif // BOT_H
@@ -1,19 +1,17 @@
-#include <sys/socket.h>
-#include <netinet/in.h>
-#include <arpa/inet.h>
 #include <unistd.h>
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
-#include <fcntl.h>
 #include <errno.h>
 #include <termios.h>
 #include <sys/select.h>
 #include <time.h>
 
 #include "shared.h"
+#include "net.h"
+#include "transport.h"
 
-static int sock = -1;
+static transport_t transport;      // Server alebo offline engine
 static int playerId = -1;  // Unikátny ID hráča
 static int gameId = -1;
 static struct termios origTermios;
@@ -23,399 +21,909 @@ static void disable_raw_mode(void) {
 }
 
 static void enable_raw_mode(void) {
+    static int registered = 0;
     tcgetattr(STDIN_FILENO, &origTermios);
-    atexit(disable_raw_mode);
+    if (!registered) {
+        atexit(disable_raw_mode);
+        registered = 1;
+    }
     
     struct termios raw = origTermios;
     raw.c_lflag &= ~(ECHO | ICANON);
     tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw);
 }
 
-// Nastaví socket na non-blocking mode
-static void set_nonblocking(int fd) {
-    int flags = fcntl(fd, F_GETFL, 0);
-    if (fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
-        perror("fcntl");
+// Dekódovaný výrez zo servera
+typedef struct ViewFrame {
+    view_header_t header;
+    char map[VIEW_HEIGHT][VIEW_WIDTH];
+    int snakeCount;
+    view_snake_t snakes[VIEW_MAX_SNAKES];
+    int enterCount;
+    int leaveCount;
+    int16_t entered[VIEW_MAX_EVENTS];
+    int16_t left[VIEW_MAX_EVENTS];
+} view_frame_t;
+
+static char eventLine[128]; // Posledné udalosti enter/leave, drží sa medzi snímkami
+
+// Telemetria pre debug overlay (kláves I)
+typedef struct NetStats {
+    int showOverlay;
+    int havePing;          // Prišiel aspoň jeden MSG_PING (offline hra ho nemá)
+    int rttUs;             // Namerané serverom a poslané v pingu
+    int jitterUs;
+    int serverQueue;       // Neodoslané bajty pre nás na serveri
+    uint32_t clockOffsetUs; // hodiny servera - hodiny klienta (odhad z pingu a RTT)
+    int stateAgeUs;        // Vek posledného výrezu pri prijatí
+} net_stats_t;
+
+static net_stats_t netStats;
+
+// Znak hlavy hadíka podľa slotu
+static char snake_char(int slot) {
+    return (char)('@' + slot % 27);
+}
+
+static void put_cell(view_frame_t *frame, view_cell_t c, char ch) {
+    if (c.x >= 0 && c.x < frame->header.viewWidth && c.y >= 0 && c.y < frame->header.viewHeight) {
+        frame->map[c.y][c.x] = ch;
     }
 }
 
-// Vykresľuje hru
-static void render_game(const game_state_t *state) {
-    system("clear");
-    printf("=== HADÍK - Hra ID: %d ===\n", state->gameId);
-    printf("Čas: %d s | Hráči: %d\n\n", state->elapsedTime, state->playerCount);
-    
-    // Vytvor mapu
-    char map[WORLD_HEIGHT][WORLD_WIDTH];
-    memset(map, ' ', sizeof(map));
-    
-    // Vlož ovocie
-    for (int f = 0; f < state->foodCount; f++) {
-        if (state->food[f].y >= 0 && state->food[f].y < WORLD_HEIGHT &&
-            state->food[f].x >= 0 && state->food[f].x < WORLD_WIDTH) {
-            map[state->food[f].y][state->food[f].x] = '*';
+// Telo na políčku i oblasti výrezu (výrez s okrajom, po riadkoch)
+static void put_region_cell(view_frame_t *frame, int i, int regionWidth) {
+    view_cell_t c = {(int8_t)(i % regionWidth - frame->header.marginX),
+                     (int8_t)(i / regionWidth - frame->header.marginY)};
+    put_cell(frame, c, 'o');
+}
+
+// Rozbalí telá z bitmapy alebo behov oblasti, vráti počet prečítaných bajtov alebo -1
+static int decode_region(const uint8_t *buf, int length, view_frame_t *frame) {
+    const view_header_t *h = &frame->header;
+    int regionWidth = h->viewWidth + 2 * h->marginX;
+    int area = regionWidth * (h->viewHeight + 2 * h->marginY);
+    if (h->encoding == VIEW_ENC_BITMAP) {
+        int bytes = (area + 7) / 8;
+        if (bytes > length) return -1;
+        for (int i = 0; i < area; i++) {
+            if ((buf[i >> 3] >> (i & 7)) & 1) put_region_cell(frame, i, regionWidth);
         }
+        return bytes;
     }
-    
-    // Vlož hadíkov
-    for (int i = 0; i < MAX_PLAYERS; i++) {
-        if (state->snakes[i].playerId == -1) continue;  // Voľný slot
-        if (!state->snakes[i].alive) continue;
-        char ch = '@' + i; // Rôzne znaky pre rôznych hráčov
-        for (int j = 0; j < state->snakes[i].length; j++) {
-            int x = state->snakes[i].body[j].x;
-            int y = state->snakes[i].body[j].y;
-            if (x >= 0 && x < WORLD_WIDTH && y >= 0 && y < WORLD_HEIGHT) {
-                map[y][x] = (j == 0) ? ch : 'o'; // Hlava vs telo
+
+    int used = 0, covered = 0;
+    for (int occupied = 0; covered < area; occupied = !occupied) {
+        if (used >= length) return -1;
+        int run = buf[used++];
+        if (covered + run > area) return -1;
+        for (int i = covered; occupied && i < covered + run; i++) put_region_cell(frame, i, regionWidth);
+        covered += run;
+    }
+    return used;
+}
+
+// Rozbalí MSG_VIEW payload do mapy výrezu, vráti 0 alebo -1 pri poškodenej správe
+static int decode_view(const char *buf, int length, view_frame_t *frame) {
+    if (length < (int)sizeof(view_header_t)) return -1;
+    memset(frame, 0, sizeof(*frame));
+    memcpy(&frame->header, buf, sizeof(view_header_t));
+    view_header_t *h = &frame->header;
+    if (h->viewWidth < 0 || h->viewWidth > VIEW_WIDTH ||
+        h->viewHeight < 0 || h->viewHeight > VIEW_HEIGHT ||
+        h->snakeCount < 0 || h->snakeCount > VIEW_MAX_SNAKES || h->foodCount < 0 ||
+        h->enterCount < 0 || h->enterCount > VIEW_MAX_EVENTS ||
+        h->leaveCount < 0 || h->leaveCount > VIEW_MAX_EVENTS || h->encoding >= VIEW_ENC_COUNT ||
+        h->marginX < 0 || h->marginX > VIEW_MARGIN || h->marginY < 0 || h->marginY > VIEW_MARGIN) {
+        return -1;
+    }
+    memset(frame->map, ' ', sizeof(frame->map));
+    int pos = (int)sizeof(view_header_t);
+    // Pri BITMAP a RLE sa hlavy kreslia až po telách z oblasti
+    view_cell_t heads[VIEW_MAX_SNAKES];
+    char headChars[VIEW_MAX_SNAKES];
+    int headCount = 0;
+
+    for (int s = 0; s < h->snakeCount; s++) {
+        view_snake_t vs;
+        if (pos + (int)sizeof(vs) > length) return -1;
+        memcpy(&vs, buf + pos, sizeof(vs));
+        pos += (int)sizeof(vs);
+        if (vs.cellCount < 0 || (h->encoding != VIEW_ENC_LIST && vs.cellCount > 1) ||
+            vs.cellCount > (length - pos) / (int)sizeof(view_cell_t)) {
+            return -1;
+        }
+        for (int k = 0; k < vs.cellCount; k++) {
+            view_cell_t c;
+            memcpy(&c, buf + pos, sizeof(c));
+            pos += (int)sizeof(c);
+            int head = k == 0 && (vs.flags & VIEW_SNAKE_HEAD);
+            char ch = head ? snake_char(vs.slot) : 'o'; // Hlava vs telo
+            if (h->encoding == VIEW_ENC_LIST) {
+                put_cell(frame, c, ch);
+            } else {
+                heads[headCount] = c;
+                headChars[headCount++] = ch;
             }
         }
+        frame->snakes[frame->snakeCount++] = vs;
     }
+    if (h->encoding != VIEW_ENC_LIST) {
+        int used = decode_region((const uint8_t *)buf + pos, length - pos, frame);
+        if (used < 0) return -1;
+        pos += used;
+        for (int k = 0; k < headCount; k++) put_cell(frame, heads[k], headChars[k]);
+    }
+
+    if (h->foodCount > (length - pos) / (int)sizeof(view_cell_t)) return -1;
+    for (int f = 0; f < h->foodCount; f++) {
+        view_cell_t c;
+        memcpy(&c, buf + pos, sizeof(c));
+        pos += (int)sizeof(c);
+        // Ovocie neprekryje hadíka
+        if (c.x >= 0 && c.x < h->viewWidth && c.y >= 0 && c.y < h->viewHeight &&
+            frame->map[c.y][c.x] == ' ') {
+            frame->map[c.y][c.x] = '*';
+        }
+    }
+
+    int events = h->enterCount + h->leaveCount;
+    if (pos + events * (int)sizeof(int16_t) > length) return -1;
+    memcpy(frame->entered, buf + pos, (size_t)h->enterCount * sizeof(int16_t));
+    pos += h->enterCount * (int)sizeof(int16_t);
+    memcpy(frame->left, buf + pos, (size_t)h->leaveCount * sizeof(int16_t));
+    frame->enterCount = h->enterCount;
+    frame->leaveCount = h->leaveCount;
+    return 0;
+}
+
+// Zapamätá si udalosti výrezu pre riadok pod skóre
+static void note_events(const view_frame_t *frame) {
+    if (frame->enterCount == 0 && frame->leaveCount == 0) return;
+    int n = snprintf(eventLine, sizeof(eventLine), "[%ds]", frame->header.elapsedTime);
+    for (int i = 0; i < frame->enterCount && n < (int)sizeof(eventLine); i++) {
+        n += snprintf(eventLine + n, sizeof(eventLine) - (size_t)n, " +%d", frame->entered[i]);
+    }
+    for (int i = 0; i < frame->leaveCount && n < (int)sizeof(eventLine); i++) {
+        n += snprintf(eventLine + n, sizeof(eventLine) - (size_t)n, " -%d", frame->left[i]);
+    }
+}
+
+// Vykresľuje výrez hry
+static void render_game(const view_frame_t *frame) {
+    const view_header_t *h = &frame->header;
+    system("clear");
+    printf("=== HADÍK - Hra ID: %d ===\n", h->gameId);
+    printf("Čas: %d s | Hráči: %d | Svet %dx%d, výrez od [%d,%d]\n\n",
+           h->elapsedTime, h->playerCount, h->worldWidth, h->worldHeight, h->originX, h->originY);
     
     // Vykresli mapu
     printf("┌");
-    for (int x = 0; x < WORLD_WIDTH; x++) printf("─");
+    for (int x = 0; x < h->viewWidth; x++) printf("─");
     printf("┐\n");
     
-    for (int y = 0; y < WORLD_HEIGHT; y++) {
+    for (int y = 0; y < h->viewHeight; y++) {
         printf("│");
-        for (int x = 0; x < WORLD_WIDTH; x++) {
-            printf("%c", map[y][x]);
+        for (int x = 0; x < h->viewWidth; x++) {
+            printf("%c", frame->map[y][x]);
         }
         printf("│\n");
     }
     
     printf("└");
-    for (int x = 0; x < WORLD_WIDTH; x++) printf("─");
+    for (int x = 0; x < h->viewWidth; x++) printf("─");
     printf("┘\n\n");
     
-    // Vypíš skóre
+    // Vypíš skóre hadíkov vo výhľade (vlastný je prvý)
     printf("SKÓRE:\n");
-    for (int i = 0; i < MAX_PLAYERS; i++) {
-        if (state->snakes[i].playerId == -1) continue;  // Voľný slot
+    for (int s = 0; s < frame->snakeCount; s++) {
+        const view_snake_t *vs = &frame->snakes[s];
         char status[20] = "";
-        if (!state->snakes[i].alive) {
+        if (!(vs->flags & VIEW_SNAKE_ALIVE)) {
             strcpy(status, "[MŔTVY]");
-        } else if (state->snakes[i].paused) {
+        } else if (vs->flags & VIEW_SNAKE_PAUSED) {
             strcpy(status, "[PAUZA]");
         }
-        printf("  Hráč %d: %d bodov %s\n", i, state->snakes[i].score, status);
+        printf("  %s %d (%c): %d bodov %s\n", vs->slot == h->selfSlot ? "Ty  " : "Hráč",
+               vs->slot, snake_char(vs->slot), vs->score, status);
+    }
+    if (eventLine[0]) {
+        printf("Vo výhľade (+prišiel/-odišiel): %s\n", eventLine);
+    }
+    if (netStats.showOverlay) {
+        if (netStats.havePing) {
+            printf("[net] RTT %.2f ms ±%.2f | vek stavu %.2f ms | fronta na serveri %d B\n",
+                   netStats.rttUs / 1000.0, netStats.jitterUs / 1000.0,
+                   netStats.stateAgeUs / 1000.0, netStats.serverQueue);
+        } else {
+            printf("[net] bez merania RTT | vek stavu %.2f ms\n", netStats.stateAgeUs / 1000.0);
+        }
     }
-    printf("\nPokyny: W/A/S/D - pohyb, P - menu, Q - odchod\n");
-    if (!state->gameRunning) {
+    printf("\nPokyny: W/A/S/D - pohyb, P - menu, Q - odchod, I - info o spojení\n");
+    if (!h->gameRunning) {
         printf("\n[HRA SKONČILA]\n");
     }
     
 }
 
+// Stavy klientskej slučky. Menu aj hra bežia v jednej select slučke,
+// takže socket sa číta stále a server nikdy nečaká na plný buffer klienta.
+typedef enum {
+    STATE_MENU,        // Čaká sa na riadok s voľbou
+    STATE_JOIN_LIST,   // Čaká sa na MSG_GAME_LIST
+    STATE_JOIN_PROMPT, // Čaká sa na riadok s ID hry
+    STATE_BOARD_WAIT,  // Čaká sa na MSG_LEADERBOARD
+    STATE_BOARD_SHOW,  // Rebríček vypísaný, Enter vráti menu
+    STATE_WAITING,     // Čaká sa na prvý výrez novej hry
+    STATE_COUNTDOWN,   // Krátka pauza pred štartom
+    STATE_PLAYING,     // Raw mode, klávesy idú na server
+    STATE_EXIT
+} client_state_t;
+
+#define LOOP_TIMEOUT_MS 50
+#define LIST_TIMEOUT_MS 1000
+#define WAIT_TIMEOUT_MS 5000
+#define COUNTDOWN_MS 2000
+
+static client_state_t state = STATE_MENU;
+static long long stateDeadline;   // Kedy vyprší aktuálny stav (ms, monotónny čas)
+static int oldGameId = -1;        // Hra, do ktorej sa dá pokračovať
+static int joinTarget = -1;       // Hra, na ktorej výrez čakáme po JOIN
+static int quitGameId = -1;       // Opustená hra, jej oneskorené výrezy sa ignorujú
+static int exitCode = 0;
+static int rawMode = 0;
+static int stdinClosed = 0;       // EOF na termináli, stdin sa už nesleduje
+static direction_t currentDir = DIR_RIGHT;
+static view_frame_t frame;
+static int frameReady = 0;        // frame obsahuje platný výrez
+static int frameDirty = 0;        // Prišiel nový výrez od posledného vykreslenia
+static char lineBuf[64];
+static int lineLen = 0;
+
+static long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static long long now_ms(void) {
+    return now_ns() / 1000000;
+}
+
 // Pošle vstup na server
 static int send_input(action_t action, direction_t direction) {
     client_input_t input;
+    memset(&input, 0, sizeof(input));
     input.playerId = playerId;
     input.action = action;
     input.direction = direction;
     input.gameId = gameId;
-    
-    ssize_t n = send(sock, &input, sizeof(input), 0);
-    return n == sizeof(input) ? 0 : -1;
+    return transport.send_input(&transport, &input);
 }
 
-// Čaká na stav hry zo servera
-static int recv_game_state(game_state_t *state) {
-    ssize_t n = recv(sock, state, sizeof(game_state_t), 0);
-    if (n == sizeof(game_state_t)) {
-        gameId = state->gameId;
-        return 0;
-    }
-    if (n == 0) {
-        printf("Server zatvoril spojenie\n");
-        return -1;
-    }
-    if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
-        perror("recv");
-        return -1;
-    }
-    return 1; // Žiadne dáta, retry
-}
-// Zobrazí menu a vráti voľbu (1-4 s aktívnou hrou, 1-3 bez nej)
-static int show_menu(int has_active_game) {
+// Zobrazí menu (voľby 1-6 s aktívnou hrou, 1-5 bez nej), vstup číta hlavná slučka
+static void show_menu(int has_active_game) {
     system("clear");
     printf("=== HADÍK - Menu ===\n");
     if (has_active_game) {
         printf("1. Pokračovať v hre\n");
         printf("2. Vytvoriť novú hru\n");
         printf("3. Pripojiť sa k inej hre\n");
-        printf("4. Ukončiť program\n");
-        printf("Zvoľ možnosť (1-4): ");
+        printf("4. Rýchle pripojenie\n");
+        printf("5. Rebríček\n");
+        printf("6. Ukončiť program\n");
+        printf("Zvoľ možnosť (1-6): ");
     } else {
         printf("1. Vytvoriť novú hru\n");
         printf("2. Pripojiť sa k hre\n");
-        printf("3. Ukončiť program\n");
-        printf("Zvoľ možnosť (1-3): ");
+        printf("3. Rýchle pripojenie\n");
+        printf("4. Rebríček\n");
+        printf("5. Ukončiť program\n");
+        printf("Zvoľ možnosť (1-5): ");
     }
     fflush(stdout);
-    
-    int choice = 0;
-    if (scanf("%d", &choice) != 1) {
-        return -1;
+}
+
+// Vypíše prijatý zoznam hier
+static void print_game_list(const char *payload, int length) {
+    game_list_t list;
+    memset(&list, 0, sizeof(list));
+    memcpy(&list, payload, (size_t)length < sizeof(list) ? (size_t)length : sizeof(list));
+    if (list.count == 0) {
+        printf("Žiadne bežiace hry\n");
+        return;
     }
-    int c;
-    while ((c = getchar()) != '\n' && c != EOF);
-    return choice;
+    printf("\n ID | Hráči | Voľné | Čas  | Tick   | RTT     | Top skóre\n");
+    for (int g = 0; g < list.count && g < MAX_PLAYERS; g++) {
+        const game_summary_t *gs = &list.games[g];
+        printf(" %2d | %5d | %5d | %3ds | %4dus | %5.1fms | %d\n",
+               gs->gameId, gs->playerCount, gs->freeSlots, gs->elapsedTime,
+               gs->tickCostUs, gs->avgRttUs / 1000.0, gs->topScore);
+    }
+    printf("\n");
 }
 
-// Spracuje menu a vráti: 0=pokračovanie, 1=nová hra, 2=join iná hra, -1=exit
-// out_gid sa naplní ak ide o join
-static int handle_menu(int *out_gid, int has_active_game, int active_game_id) {
-    int choice = show_menu(has_active_game);
-    
-    if (choice < 0) {
+// Vypíše prijatý rebríček a riadok tohto hráča
+static void print_leaderboard(const char *payload, int length) {
+    leaderboard_t board;
+    memset(&board, 0, sizeof(board));
+    memcpy(&board, payload, (size_t)length < sizeof(board) ? (size_t)length : sizeof(board));
+    if (board.count == 0) {
+        printf("\nRebríček je prázdny\n\n");
+        return;
+    }
+    printf("\n  # | Hráč       | Top skóre | Hry  | Ovocie | Prežité\n");
+    for (int k = 0; k < board.count && k < LEADERBOARD_SIZE; k++) {
+        const player_stats_t *p = &board.top[k];
+        printf(" %2d | %10d | %9d | %4d | %6d | %5ds%s\n", k + 1, p->playerId, p->highScore,
+               p->gamesPlayed, p->foodEaten, p->survivalSec, p->playerId == playerId ? "  <- ty" : "");
+    }
+    if (board.rank > 0) {
+        printf("\nTvoje poradie: %d. (top skóre %d, %d hier)\n\n", board.rank,
+               board.self.highScore, board.self.gamesPlayed);
+    } else {
+        printf("\nZatiaľ nemáš žiadnu dohratú hru\n\n");
+    }
+}
+
+// Prechod do nového stavu vrátane jeho vstupnej akcie
+static void enter_state(client_state_t next) {
+    state = next;
+    lineLen = 0;
+    switch (next) {
+        case STATE_MENU:
+            if (rawMode) {
+                disable_raw_mode();
+                rawMode = 0;
+            }
+            frameReady = 0;
+            show_menu(oldGameId >= 0);
+            break;
+        case STATE_JOIN_LIST: {
+            client_input_t input;
+            memset(&input, 0, sizeof(input));
+            input.playerId = playerId;
+            input.gameId = -1;
+            input.action = ACTION_LIST_GAMES;
+            input.direction = DIR_NONE;
+            transport.send_input(&transport, &input);
+            stateDeadline = now_ms() + LIST_TIMEOUT_MS;
+            break;
+        }
+        case STATE_JOIN_PROMPT:
+            printf("Zadaj ID hry (0-%d): ", MAX_PLAYERS - 1);
+            fflush(stdout);
+            break;
+        case STATE_BOARD_WAIT:
+            send_input(ACTION_LEADERBOARD, DIR_NONE);
+            stateDeadline = now_ms() + LIST_TIMEOUT_MS;
+            break;
+        case STATE_BOARD_SHOW:
+            printf("Stlač Enter pre návrat do menu: ");
+            fflush(stdout);
+            break;
+        case STATE_WAITING:
+            printf("Čakám na server...\n");
+            eventLine[0] = '\0';
+            frameReady = 0;
+            stateDeadline = now_ms() + WAIT_TIMEOUT_MS;
+            break;
+        case STATE_COUNTDOWN:
+            printf("Hra pripravená! Ovládanie: W/A/S/D, P - menu, Q - ukončiť\n");
+            printf("Spúšťam za 2 sekundy...\n");
+            stateDeadline = now_ms() + COUNTDOWN_MS;
+            break;
+        case STATE_PLAYING:
+            if (!rawMode) {
+                enable_raw_mode();
+                rawMode = 1;
+            }
+            currentDir = DIR_RIGHT;
+            frameDirty = frameReady;
+            break;
+        case STATE_EXIT:
+            if (rawMode) {
+                disable_raw_mode();
+                rawMode = 0;
+            }
+            break;
+    }
+}
+
+// Opustí aktívnu hru pred vytvorením/pripojením inej
+static void leave_active_game(void) {
+    if (oldGameId < 0) return;
+    send_input(ACTION_QUIT, DIR_NONE);
+    quitGameId = oldGameId;
+    oldGameId = -1;
+}
+
+// Spracuje riadok z menu (rovnaké voľby ako predtým)
+static void handle_menu_line(const char *line) {
+    int hasActive = oldGameId >= 0;
+    int choice = 0;
+    if (sscanf(line, "%d", &choice) != 1) {
         printf("Neplatný vstup\n");
-        return -1;
+        enter_state(STATE_EXIT);
+        return;
     }
-    
 
-    if (choice == 1 && has_active_game) {
+    // Bez aktívnej hry chýba voľba "Pokračovať", ostatné sú o jednu nižšie
+    int item = hasActive ? choice : choice + 1;
+    if (item == 1 && hasActive) {
         // Pokračovať
-        printf("Pokračujem v hre %d...\n", active_game_id);
-        return 0;
-    } else if ((choice == 1 && !has_active_game) || (choice == 2 && has_active_game)) {
-        // Nová hra
-        if (has_active_game) {
-            send_input(ACTION_QUIT, DIR_NONE);
-            usleep(100000);
+        printf("Pokračujem v hre %d...\n", oldGameId);
+        gameId = oldGameId;
+        enter_state(STATE_COUNTDOWN);
+    } else if (item == 2 || item == 4) {
+        // Nová hra alebo rýchle pripojenie (hru vyberie server)
+        leave_active_game();
+        printf(item == 2 ? "Vytváram novú hru...\n" : "Hľadám hru...\n");
+        gameId = -1;
+        joinTarget = -1;
+        if (send_input(item == 2 ? ACTION_CREATE_GAME : ACTION_QUICK_JOIN, DIR_NONE) < 0) {
+            perror("send failed");
+            exitCode = 1;
+            enter_state(STATE_EXIT);
+            return;
         }
-        printf("Vytváram novú hru...\n");
-        return 1;
-    } else if ((choice == 2 && !has_active_game) || (choice == 3 && has_active_game)) {
+        enter_state(STATE_WAITING);
+    } else if (item == 3) {
         // Join iná hra
-        if (has_active_game) {
-            send_input(ACTION_QUIT, DIR_NONE);
-            usleep(100000);
-        }
-        
-        printf("Zadaj ID hry (0-%d): ", MAX_PLAYERS - 1);
-        fflush(stdout);
-        if (scanf("%d", out_gid) != 1) {
-            printf("Neplatný vstup\n");
-            return -1;
-        }
-        int c;
-        while ((c = getchar()) != '\n' && c != EOF);
-        printf("Pripájam sa k hre %d...\n", *out_gid);
-        return 2;
+        leave_active_game();
+        enter_state(STATE_JOIN_LIST);
+    } else if (item == 5) {
+        // Rebríček, rozohraná hra ostáva
+        enter_state(STATE_BOARD_WAIT);
     } else {
         // Exit
-        if (has_active_game) {
+        if (hasActive) {
             send_input(ACTION_QUIT, DIR_NONE);
         }
         printf("Ukončujem...\n");
+        enter_state(STATE_EXIT);
+    }
+}
+
+// Spracuje riadok s ID hry a pošle JOIN
+static void handle_join_line(const char *line) {
+    int gid;
+    if (sscanf(line, "%d", &gid) != 1) {
+        printf("Neplatný vstup\n");
+        enter_state(STATE_EXIT);
+        return;
+    }
+    printf("Pripájam sa k hre %d...\n", gid);
+    gameId = gid;
+    joinTarget = gid;
+    if (send_input(ACTION_JOIN_GAME, DIR_NONE) < 0) {
+        perror("send failed");
+        exitCode = 1;
+        enter_state(STATE_EXIT);
+        return;
+    }
+    enter_state(STATE_WAITING);
+}
+
+// Klávesa počas hry
+static void handle_game_key(char ch) {
+    switch (ch) {
+        case 'w':
+        case 'W':
+            if (currentDir != DIR_DOWN) {
+                currentDir = DIR_UP;
+                send_input(ACTION_MOVE, currentDir);
+            }
+            break;
+        case 's':
+        case 'S':
+            if (currentDir != DIR_UP) {
+                currentDir = DIR_DOWN;
+                send_input(ACTION_MOVE, currentDir);
+            }
+            break;
+        case 'a':
+        case 'A':
+            if (currentDir != DIR_RIGHT) {
+                currentDir = DIR_LEFT;
+                send_input(ACTION_MOVE, currentDir);
+            }
+            break;
+        case 'd':
+        case 'D':
+            if (currentDir != DIR_LEFT) {
+                currentDir = DIR_RIGHT;
+                send_input(ACTION_MOVE, currentDir);
+            }
+            break;
+        case 'q':
+        case 'Q':
+        case 3:
+            send_input(ACTION_QUIT, DIR_NONE);
+            oldGameId = -1;
+            enter_state(STATE_EXIT);
+            break;
+        case 'i':
+        case 'I':
+            netStats.showOverlay = !netStats.showOverlay;
+            frameDirty = frameReady;
+            break;
+        case 'p':
+        case 'P':
+            // Pauza - vráť sa do menu, hra beží ďalej a výrezy sa zahadzujú
+            send_input(ACTION_PAUSE, DIR_NONE);
+            oldGameId = gameId;
+            enter_state(STATE_MENU);
+            break;
+    }
+}
+
+// Prečíta dostupný vstup z terminálu bez blokovania
+static void handle_stdin(void) {
+    char ch = 0;
+    if (read(STDIN_FILENO, &ch, 1) <= 0) {
+        stdinClosed = 1;
+        return;
+    }
+    if (state == STATE_PLAYING) {
+        handle_game_key(ch);
+        return;
+    }
+    if (state != STATE_MENU && state != STATE_JOIN_PROMPT && state != STATE_BOARD_SHOW) return; // Písanie mimo výziev sa zahodí
+    if (ch != '\n') {
+        if (lineLen < (int)sizeof(lineBuf) - 1) lineBuf[lineLen++] = ch;
+        return;
+    }
+    lineBuf[lineLen] = '\0';
+    lineLen = 0;
+    if (state == STATE_MENU) {
+        handle_menu_line(lineBuf);
+    } else if (state == STATE_BOARD_SHOW) {
+        enter_state(STATE_MENU);
+    } else {
+        handle_join_line(lineBuf);
+    }
+}
+
+// Ping zo servera: hneď odpovedz a zapamätaj si merania pre overlay
+static void handle_ping(const char *payload, int length) {
+    if (length < (int)sizeof(ping_t)) return;
+    ping_t ping;
+    memcpy(&ping, payload, sizeof(ping));
+
+    client_input_t pong;
+    memset(&pong, 0, sizeof(pong));
+    pong.playerId = playerId;
+    pong.gameId = gameId;
+    pong.action = ACTION_PONG;
+    pong.direction = DIR_NONE;
+    pong.stamp = ping.stamp;
+    transport.send_input(&transport, &pong);
+
+    netStats.havePing = 1;
+    netStats.rttUs = ping.rttUs;
+    netStats.jitterUs = ping.jitterUs;
+    netStats.serverQueue = ping.sendQueue;
+    // Ping letel k nám približne polovicu RTT
+    netStats.clockOffsetUs = ping.stamp + (uint32_t)(ping.rttUs / 2) - net_clock_us();
+}
+
+// Výrez je zaujímavý iba v herných stavoch; pri čakaní na novú hru
+// sa ignorujú výrezy opustenej hry, resp. iných hier než cieľa JOIN
+static int view_wanted(int viewGameId) {
+    if (state == STATE_COUNTDOWN || state == STATE_PLAYING) return 1;
+    if (state != STATE_WAITING) return 0;
+    if (joinTarget >= 0) return viewGameId == joinTarget;
+    return viewGameId != quitGameId;
+}
+
+// Vyprázdni transport, vráti -1 ak server zatvoril spojenie
+static int drain_transport(void) {
+    static char payload[VIEW_MAX_BYTES];
+    msg_header_t hdr;
+    int ret;
+    while ((ret = transport.recv_msg(&transport, &hdr, payload, sizeof(payload))) == 1) {
+        if (hdr.type == MSG_PING) {
+            handle_ping(payload, hdr.length);
+            continue;
+        }
+        if (hdr.type == MSG_GAME_LIST) {
+            if (state == STATE_JOIN_LIST) {
+                print_game_list(payload, hdr.length);
+                enter_state(STATE_JOIN_PROMPT);
+            }
+            continue;
+        }
+        if (hdr.type == MSG_LEADERBOARD) {
+            if (state == STATE_BOARD_WAIT) {
+                print_leaderboard(payload, hdr.length);
+                enter_state(STATE_BOARD_SHOW);
+            }
+            continue;
+        }
+        if (hdr.type != MSG_VIEW || hdr.length < (int)sizeof(view_header_t)) continue;
+
+        view_header_t peek;
+        memcpy(&peek, payload, sizeof(peek));
+        if (!view_wanted(peek.gameId)) continue; // Zastaraný výrez, zahodí sa bez dekódovania
+        if (decode_view(payload, hdr.length, &frame) != 0) continue;
+        // Bez pingu (offline) sú hodiny servera aj klienta tie isté
+        netStats.stateAgeUs = (int)(net_clock_us() + netStats.clockOffsetUs - frame.header.tickStampUs);
+        gameId = frame.header.gameId;
+        note_events(&frame);
+        frameReady = 1;
+        frameDirty = 1;
+        if (state == STATE_WAITING) {
+            oldGameId = gameId;
+            quitGameId = -1;
+            enter_state(STATE_COUNTDOWN);
+        }
+    }
+    if (ret < 0) {
+        printf("Server zatvoril spojenie\n");
         return -1;
     }
+    return 0;
 }
 
-// Spustí hru, vráti 1 ak sa hráč chce vrátiť do menu, 0 ak chce exit
-static int play_game(int *out_old_game_id) {
-    printf("Hra pripravená! Ovládanie: W/A/S/D, P - menu, Q - ukončiť\n");
-    printf("Spúšťam za 2 sekundy...\n");
-    sleep(2);
-    
-    // Raw mode
-    enable_raw_mode();
-    set_nonblocking(sock);
-    
-    direction_t currentDir = DIR_RIGHT;
-    int running = 1;
-    game_state_t state;
-    memset(&state, 0, sizeof(state));
-    
-    // Načítaj aktuálny stav
-    for (int i = 0; i < 20; i++) {
-        if (recv_game_state(&state) == 0) break;
-        usleep(50000);
+// Vypršanie časových stavov
+static void check_deadlines(void) {
+    if (now_ms() < stateDeadline) return;
+    if (state == STATE_JOIN_LIST) {
+        enter_state(STATE_JOIN_PROMPT); // Zoznam neprišiel, ID sa dá zadať aj tak
+    } else if (state == STATE_BOARD_WAIT) {
+        printf("\nRebríček nie je dostupný\n\n");
+        enter_state(STATE_BOARD_SHOW);
+    } else if (state == STATE_WAITING) {
+        printf("Nepodarilo sa získať stav hry\n");
+        exitCode = 1;
+        enter_state(STATE_EXIT);
+    } else if (state == STATE_COUNTDOWN) {
+        enter_state(STATE_PLAYING);
     }
-    render_game(&state);
-    
-    // Hlavný loop
-    while (running) {
+}
+
+// Hlavná slučka: jeden select nad terminálom a transportom pre všetky stavy
+static void run_event_loop(void) {
+    enter_state(STATE_MENU);
+    while (state != STATE_EXIT) {
         fd_set rfds;
         FD_ZERO(&rfds);
-        FD_SET(STDIN_FILENO, &rfds);
-        FD_SET(sock, &rfds);
+        if (!stdinClosed) FD_SET(STDIN_FILENO, &rfds);
+        int fd = transport.poll_fd(&transport);
+        if (fd >= 0) FD_SET(fd, &rfds);
         
+        // Offline engine nemá deskriptor, zobudí nás jeho najbližší tick
+        int timeoutMs = LOOP_TIMEOUT_MS;
+        int waitMs = transport.wait_ms(&transport);
+        if (waitMs >= 0 && waitMs < timeoutMs) timeoutMs = waitMs;
         struct timeval tv;
         tv.tv_sec = 0;
-        tv.tv_usec = 50000;
+        tv.tv_usec = timeoutMs * 1000;
         
-        int ret = select(sock + 1, &rfds, NULL, NULL, &tv);
+        int ret = select((fd > STDIN_FILENO ? fd : STDIN_FILENO) + 1, &rfds, NULL, NULL, &tv);
+        if (ret < 0) {
+            if (errno == EINTR) continue;
+            perror("select");
+            exitCode = 1;
+            break;
+        }
         
+        if ((fd < 0 || (ret > 0 && FD_ISSET(fd, &rfds))) && drain_transport() < 0) {
+            if (state == STATE_WAITING) exitCode = 1;
+            break;
+        }
         if (ret > 0 && FD_ISSET(STDIN_FILENO, &rfds)) {
-            char ch = 0;
-            if (read(STDIN_FILENO, &ch, 1) > 0) {
-                switch (ch) {
-                    case 'w':
-                    case 'W':
-                        if (currentDir != DIR_DOWN) {
-                            currentDir = DIR_UP;
-                            send_input(ACTION_MOVE, currentDir);
-                        }
-                        break;
-                    case 's':
-                    case 'S':
-                        if (currentDir != DIR_UP) {
-                            currentDir = DIR_DOWN;
-                            send_input(ACTION_MOVE, currentDir);
-                        }
-                        break;
-                    case 'a':
-                    case 'A':
-                        if (currentDir != DIR_RIGHT) {
-                            currentDir = DIR_LEFT;
-                            send_input(ACTION_MOVE, currentDir);
-                        }
-                        break;
-                    case 'd':
-                    case 'D':
-                        if (currentDir != DIR_LEFT) {
-                            currentDir = DIR_RIGHT;
-                            send_input(ACTION_MOVE, currentDir);
-                        }
-                        break;
-                    case 'q':
-                    case 'Q':
-                    case 3:
-                        send_input(ACTION_QUIT, DIR_NONE);
-                        disable_raw_mode();
-                        *out_old_game_id = -1;
-                        return 0; // Exit program
-                    case 'p':
-                    case 'P':
-                        // Pauza - vráť sa do menu
-                        send_input(ACTION_PAUSE, DIR_NONE);
-                        disable_raw_mode();
-                        *out_old_game_id = gameId;
-                        return 1; // Vráť sa do menu
-                }
-            }
+            handle_stdin();
+        }
+        if (stdinClosed && (state == STATE_MENU || state == STATE_JOIN_PROMPT || state == STATE_BOARD_SHOW)) {
+            // EOF vo výzve sa správa ako neplatný vstup
+            printf("Neplatný vstup\n");
+            enter_state(STATE_EXIT);
+            break;
+        }
+        if (state == STATE_JOIN_LIST || state == STATE_BOARD_WAIT || state == STATE_WAITING ||
+            state == STATE_COUNTDOWN) {
+            check_deadlines();
         }
         
-        if (ret > 0 && FD_ISSET(sock, &rfds)) {
-            int recv_ret = recv_game_state(&state);
-            if (recv_ret < 0) {
-                running = 0;
-            } else if (recv_ret == 0) {
-                render_game(&state);
-                if (!state.gameRunning) {
-                    running = 0;
-                }
+        if (state == STATE_PLAYING && frameDirty) {
+            frameDirty = 0;
+            render_game(&frame);
+            if (!frame.header.gameRunning) {
+                disable_raw_mode();
+                rawMode = 0;
+                printf("\nHra skončila\n");
+                oldGameId = -1;
+                enter_state(STATE_MENU);
             }
         }
     }
-    
-    disable_raw_mode();
-    printf("\nHra skončila\n");
-    *out_old_game_id = -1;
-    return 1; // Vráť sa do menu
+    if (rawMode) {
+        disable_raw_mode();
+        rawMode = 0;
+    }
 }
 
-int main() {
-    // 1. Vytvorenie socketu
-    sock = socket(AF_INET, SOCK_STREAM, 0);
-    if (sock < 0) {
-        perror("socket failed");
-        return 1;
+// Meranie dekódovania, vykresľovania a spracovania vstupu bez servera:
+// offline engine tikne pri každom výreze, hadík krúži po štvorci.
+static int run_client_bench(int frames) {
+    static char payload[VIEW_MAX_BYTES];
+    static const char keys[] = "dsaw";
+    long long decodeNs = 0, renderNs = 0, inputNs = 0;
+    int decoded = 0, inputs = 0, games = 0;
+
+    for (int f = 0; f < frames; f++) {
+        if (oldGameId < 0) {
+            gameId = -1;
+            send_input(ACTION_CREATE_GAME, DIR_NONE);
+            currentDir = DIR_RIGHT;
+            games++;
+        }
+        if (f % 4 == 0) {
+            long long t0 = now_ns();
+            handle_game_key(keys[(f / 4) % 4]);
+            inputNs += now_ns() - t0;
+            inputs++;
+        }
+
+        msg_header_t hdr;
+        if (transport.recv_msg(&transport, &hdr, payload, sizeof(payload)) != 1 || hdr.type != MSG_VIEW) {
+            continue;
+        }
+        long long t0 = now_ns();
+        if (decode_view(payload, hdr.length, &frame) != 0) continue;
+        note_events(&frame);
+        long long t1 = now_ns();
+        render_game(&frame);
+        fflush(stdout);
+        long long t2 = now_ns();
+        decodeNs += t1 - t0;
+        renderNs += t2 - t1;
+        decoded++;
+        gameId = frame.header.gameId;
+        oldGameId = frame.header.gameRunning ? gameId : -1;
     }
-    
-    // 2. Pripojenie na server
-    struct sockaddr_in addr;
-    memset(&addr, 0, sizeof(addr));
-    addr.sin_family = AF_INET;
-    addr.sin_port = htons(PORT);
-    addr.sin_addr.s_addr = inet_addr("127.0.0.1");
-    
-    if (connect(sock, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
-        perror("connect failed");
-        close(sock);
+
+    if (decoded == 0) {
+        fprintf(stderr, "Žiadne výrezy\n");
         return 1;
     }
-    
-    printf("Pripojený na server\n\n");
-    
-    // Vygeneruj unikátny ID hráča (podľa času + PID)
-    playerId = (int)time(NULL) * 1000 + getpid();
-    if (playerId < 0) playerId = -playerId;
-    
-    int oldGameId = -1;
-    
-    // Hlavná slučka - menu a hra
-    while (1) {
-        // Menu
-        int has_active = (oldGameId >= 0);
-        int join_game_id = -1;
-        int menu_result = handle_menu(&join_game_id, has_active, oldGameId);
-        
-        if (menu_result == -1) {
-            // Exit
-            break;
+    fprintf(stderr, "Výrezy: %d (hry: %d)\n", decoded, games);
+    fprintf(stderr, "Dekódovanie: %.1f us/výrez\n", decodeNs / 1000.0 / decoded);
+    fprintf(stderr, "Vykreslenie: %.1f us/výrez\n", renderNs / 1000.0 / decoded);
+    fprintf(stderr, "Vstup:       %.1f us/kláves (%d)\n", inputs ? inputNs / 1000.0 / inputs : 0.0, inputs);
+    return 0;
+}
+
+// Pripojenie: prijatý klient hneď dostane MSG_PING, odmietnutý MSG_BUSY.
+// Po odmietnutí sa skúša znova po čase od servera, najmenej však po
+// exponenciálne rastúcom odstupe s náhodným rozptylom (klienti odmietnutí
+// naraz sa nevrátia naraz).
+#define CONNECT_ATTEMPTS 6
+#define CONNECT_BACKOFF_MS 500
+#define CONNECT_BACKOFF_MAX_MS 8000
+#define ADMIT_WAIT_MS 2000     // Bez odpovede (starší server) sa spojenie považuje za prijaté
+
+// Čaká na prvú správu: vráti 0 = prijatý, > 0 = čas na nový pokus (MSG_BUSY), -1 = chyba
+static int await_admission(void) {
+    char payload[sizeof(ping_t) > sizeof(busy_t) ? sizeof(ping_t) : sizeof(busy_t)];
+    long long deadline = now_ms() + ADMIT_WAIT_MS;
+    for (long long left = ADMIT_WAIT_MS; left > 0; left = deadline - now_ms()) {
+        msg_header_t hdr;
+        int ret = transport.recv_msg(&transport, &hdr, payload, sizeof(payload));
+        if (ret < 0) return -1;
+        if (ret == 0) {
+            int fd = transport.poll_fd(&transport);
+            fd_set rfds;
+            FD_ZERO(&rfds);
+            FD_SET(fd, &rfds);
+            struct timeval tv = {(time_t)(left / 1000), (suseconds_t)(left % 1000 * 1000)};
+            select(fd + 1, &rfds, NULL, NULL, &tv);
+            continue;
         }
-        
-        if (menu_result == 0) {
-            // Pokračovať - preskočí príjem nového stavu
-            gameId = oldGameId;
-        } else if (menu_result == 1) {
-            // Nová hra
-            gameId = -1;
-            if (send_input(ACTION_CREATE_GAME, DIR_NONE) < 0) {
-                perror("send failed");
-                close(sock);
-                return 1;
-            }
-            oldGameId = -1;
-        } else if (menu_result == 2) {
-            // Join iná hra
-            gameId = join_game_id;
-            if (send_input(ACTION_JOIN_GAME, DIR_NONE) < 0) {
-                perror("send failed");
-                close(sock);
-                return 1;
-            }
-            oldGameId = -1;
+        if (hdr.type == MSG_BUSY && hdr.length >= (int)sizeof(busy_t)) {
+            busy_t busy;
+            memcpy(&busy, payload, sizeof(busy));
+            return busy.retryAfterMs > 0 ? busy.retryAfterMs : 1;
         }
-        
-        // Čakaj na prvý stav (len ak to nie je pokračovanie)
-        if (menu_result != 0) {
-            printf("Čakám na server...\n");
-            game_state_t state;
-            memset(&state, 0, sizeof(state));
-            
-            int got_state = 0;
-            for (int i = 0; i < 50 && !got_state; i++) {
-                ssize_t n = recv(sock, &state, sizeof(game_state_t), 0);
-                if (n == sizeof(game_state_t)) {
-                    gameId = state.gameId;
-                    oldGameId = gameId;
-                    got_state = 1;
-                    break;
+        if (hdr.type == MSG_PING) handle_ping(payload, hdr.length);
+        return 0;
+    }
+    return 0;
+}
+
+// Pripojí sa na server, pri odmietnutí to skúša znova; vráti 0 alebo -1
+static int connect_server(void) {
+    int backoffMs = CONNECT_BACKOFF_MS;
+    for (int attempt = 1; attempt <= CONNECT_ATTEMPTS; attempt++) {
+        if (transport_open_tcp(&transport, "127.0.0.1", PORT) < 0) return -1;
+        int retryMs = await_admission();
+        if (retryMs == 0) return 0;
+        transport.close(&transport);
+        if (retryMs < 0) {
+            printf("Server zatvoril spojenie\n");
+            return -1;
+        }
+        if (attempt == CONNECT_ATTEMPTS) break;
+
+        int delayMs = retryMs > backoffMs ? retryMs : backoffMs;
+        delayMs += rand() % (delayMs / 4 + 1);
+        printf("Server je preťažený, nový pokus o %.1f s (%d/%d)\n", delayMs / 1000.0, attempt,
+               CONNECT_ATTEMPTS - 1);
+        usleep((useconds_t)delayMs * 1000);
+        backoffMs = backoffMs * 2 < CONNECT_BACKOFF_MAX_MS ? backoffMs * 2 : CONNECT_BACKOFF_MAX_MS;
+    }
+    printf("Server je preťažený, skúste to neskôr\n");
+    return -1;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [-o] [-b frames] [-p id]\n", prog);
+    fprintf(stderr, "  -o         offline hra pre jedného hráča (engine beží v klientovi)\n");
+    fprintf(stderr, "  -b N       offline benchmark dekódovania/vykreslenia N výrezov (výsledky na stderr)\n");
+    fprintf(stderr, "  -p ID      stále ID hráča (> 0), štatistiky v rebríčku sa zbierajú naprieč spusteniami\n");
+}
+
+int main(int argc, char **argv) {
+    int offline = 0;
+    int benchFrames = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "ob:p:h")) != -1) {
+        switch (opt) {
+            case 'o':
+                offline = 1;
+                break;
+            case 'b':
+                benchFrames = atoi(optarg);
+                if (benchFrames <= 0) {
+                    usage(argv[0]);
+                    return 1;
                 }
-                usleep(100000);
-            }
-            
-            if (!got_state) {
-                printf("Nepodarilo sa získať stav hry\n");
-                close(sock);
+                break;
+            case 'p':
+                playerId = atoi(optarg);
+                if (playerId <= 0) {
+                    usage(argv[0]);
+                    return 1;
+                }
+                break;
+            default:
+                usage(argv[0]);
                 return 1;
-            }
         }
-        
-        // Spusti hru
-        int play_result = play_game(&oldGameId);
-        if (play_result == 0) {
-            // Exit program
-            break;
+    }
+    
+    // Bez -p vygeneruj unikátny ID hráča (podľa času + PID)
+    if (playerId < 0) {
+        playerId = (int)time(NULL) * 1000 + getpid();
+        if (playerId < 0) playerId = -playerId;
+    }
+    
+    if (benchFrames > 0) {
+        if (transport_open_offline(&transport, 0) < 0) return 1;
+        int rc = run_client_bench(benchFrames);
+        transport.close(&transport);
+        return rc;
+    }
+    
+    if (offline) {
+        if (transport_open_offline(&transport, GAME_LOOP_MS) < 0) {
+            fprintf(stderr, "Offline hru sa nepodarilo spustiť\n");
+            return 1;
         }
-        // play_result == 1 znamená vráť sa do menu, slučka pokračuje
+        printf("Offline hra\n\n");
+    } else {
+        srand((unsigned)(time(NULL) ^ getpid()));
+        if (connect_server() < 0) return 1;
+        printf("Pripojený na server\n\n");
     }
     
-    printf("Odpájam sa...\n");
-    close(sock);
-    return 0;
-}
\ No newline at end of file
+    run_event_loop();
+    
+    if (exitCode == 0) {
+        printf("Odpájam sa...\n");
+    }
+    transport.close(&transport);
+    return exitCode;
+}
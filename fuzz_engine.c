@@ -0,0 +1,343 @@
+#include <dirent.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "game.h"
+#include "game_ref.h"
+
+// Diferenciálny fuzz enginu: rovnaký prúd pripojení, odchodov, vstupov a tickov
+// ide do game.c aj do zmrazenej referencie game_ref.c a po každom kroku sa
+// porovná celý stav (aj mriežka obsadenosti enginu voči telám z referencie).
+// Pred každým krokom, ktorý volá rand(), dostanú oba enginy rovnaký srand().
+//
+// Vstup: [šírka][výška][hadíky][seed x4] a potom operácie, každá začína bajtom
+// s kódom (join, leave, vstup, tick, dávka tickov) a berie si 1-3 argumenty.
+//
+// Build: make fuzz (deterministický runner), make fuzz-libfuzzer (clang).
+
+#define FUZZ_PLAYER_IDS 24      // Malý priestor playerId, aby sa opakovali (rejoin, mŕtvy hráč)
+#define FUZZ_MAX_BURST 8
+#define FUZZ_MAX_INPUT 4096
+
+typedef struct FuzzInput {
+    const uint8_t *data;
+    size_t size;
+    size_t pos;
+} fuzz_input_t;
+
+static game_engine_t *engine;
+static ref_game_t *ref;
+static uint8_t expectCells[ARENA_MAX_WIDTH * ARENA_MAX_HEIGHT];
+static char failure[256];
+static int kernelCases[TICK_KERNEL_COUNT];  // Pokrytie variantov ticku
+
+static int next_byte(fuzz_input_t *in) {
+    return in->pos < in->size ? in->data[in->pos++] : 0;
+}
+
+static int mask_bit(const uint64_t *mask, int i) {
+    return (int)((mask[i >> 6] >> (i & 63)) & 1u);
+}
+
+// Predradí prefix pred popis v failure, koniec popisu sa prípadne oreže
+static void prefix_failure(const char *prefix) {
+    size_t len = strlen(prefix);
+    size_t rest = strlen(failure);
+    if (len > sizeof(failure) - 1) len = sizeof(failure) - 1;
+    if (len + rest > sizeof(failure) - 1) rest = sizeof(failure) - 1 - len;
+    memmove(failure + len, failure, rest);
+    memcpy(failure, prefix, len);
+    failure[len + rest] = '\0';
+}
+
+#define EXPECT(cond, ...)                                          \
+    do {                                                           \
+        if (!(cond)) {                                             \
+            snprintf(failure, sizeof(failure), __VA_ARGS__);       \
+            return -1;                                             \
+        }                                                          \
+    } while (0)
+
+// Porovná engine s referenciou, vráti 0 alebo -1 (popis v failure)
+static int compare_states(void) {
+    EXPECT(engine->playerCount == ref->playerCount, "playerCount %d != %d", engine->playerCount, ref->playerCount);
+    EXPECT(engine->gameRunning == ref->gameRunning, "gameRunning %d != %d", engine->gameRunning, ref->gameRunning);
+    EXPECT(engine->foodCount == ref->foodCount, "foodCount %d != %d", engine->foodCount, ref->foodCount);
+    for (int f = 0; f < ref->foodCount; f++) {
+        EXPECT(engine->food[f].x == ref->food[f].x && engine->food[f].y == ref->food[f].y,
+               "food[%d] [%d,%d] != [%d,%d]", f, engine->food[f].x, engine->food[f].y,
+               ref->food[f].x, ref->food[f].y);
+    }
+
+    int area = ref->width * ref->height;
+    memset(expectCells, 0, (size_t)area);
+    for (int f = 0; f < ref->foodCount; f++) {
+        expectCells[ref->food[f].y * ref->width + ref->food[f].x] |= CELL_FOOD;
+    }
+
+    for (int i = 0; i < ref->maxSnakes; i++) {
+        const ref_snake_t *s = &ref->snakes[i];
+        EXPECT(mask_bit(engine->usedMask, i) == s->used, "slot %d used %d != %d", i,
+               mask_bit(engine->usedMask, i), s->used);
+        EXPECT(engine->playerId[i] == s->playerId, "slot %d playerId %d != %d", i, engine->playerId[i], s->playerId);
+        EXPECT(game_player_alive(engine, i) == s->alive, "slot %d alive %d != %d", i,
+               game_player_alive(engine, i), s->alive);
+        EXPECT(game_player_paused(engine, i) == s->paused, "slot %d paused %d != %d", i,
+               game_player_paused(engine, i), s->paused);
+        if (!s->used) continue;
+        EXPECT(engine->direction[i] == s->direction, "slot %d direction %d != %d", i,
+               engine->direction[i], s->direction);
+        EXPECT(engine->length[i] == s->length, "slot %d length %d != %d", i, engine->length[i], s->length);
+        EXPECT(engine->score[i] == s->score, "slot %d score %d != %d", i, engine->score[i], s->score);
+        for (int k = 0; k < s->length; k++) {
+            position_t c = game_snake_cell(engine, i, k);
+            EXPECT(c.x == s->body[k].x && c.y == s->body[k].y, "slot %d body[%d] [%d,%d] != [%d,%d]",
+                   i, k, c.x, c.y, s->body[k].x, s->body[k].y);
+            if (s->alive) expectCells[s->body[k].y * ref->width + s->body[k].x]++;
+        }
+        if (s->alive) {
+            EXPECT(engine->headX[i] == s->body[0].x && engine->headY[i] == s->body[0].y,
+                   "slot %d head [%d,%d] != [%d,%d]", i, engine->headX[i], engine->headY[i],
+                   s->body[0].x, s->body[0].y);
+        }
+    }
+
+    for (int c = 0; c < area; c++) {
+        EXPECT(engine->cells[c] == expectCells[c], "cell [%d,%d] 0x%02x != 0x%02x",
+               c % ref->width, c / ref->width, engine->cells[c], expectCells[c]);
+    }
+    return 0;
+}
+
+// Jeden fuzz prípad, vráti 0 alebo -1 pri rozdiele (popis v failure)
+static int run_case(const uint8_t *data, size_t size) {
+    fuzz_input_t in = {data, size > FUZZ_MAX_INPUT ? FUZZ_MAX_INPUT : size, 0};
+    // Horné hodnoty bajtov rozmerov vyberajú mocniny dvojky a klasickú arénu,
+    // aby dostali prípady aj špecializované varianty ticku
+    int wb = next_byte(&in);
+    int hb = next_byte(&in);
+    int width = wb < 0xC0 ? 3 + wb % 62 : wb < 0xF0 ? 1 << (2 + wb % 5) : WORLD_WIDTH;
+    int height = wb >= 0xF0 ? WORLD_HEIGHT : hb < 0xC0 ? 1 + hb % 64 : 1 << (hb % 7);
+    int maxSnakes = 1 + next_byte(&in) % 160;  // Cez hranicu 64-bitových masiek aj paralelného ticku
+    unsigned seed = 0;
+    for (int b = 0; b < 4; b++) seed = seed << 8 | (unsigned)next_byte(&in);
+
+    game_init(engine);
+    if (game_configure(engine, width, height, maxSnakes) < 0) return 0;
+    kernelCases[engine->tickKernel]++;
+    ref_init(ref, width, height, maxSnakes);
+
+    int tick = 0;
+    for (unsigned step = 0; in.pos < in.size; step++) {
+        int op = next_byte(&in) % 5;
+        unsigned stepSeed = seed ^ (step * 2654435761u);
+        if (op == 0) {
+            int playerId = next_byte(&in) % FUZZ_PLAYER_IDS;
+            srand(stepSeed);
+            int got = game_add_player(engine, playerId);
+            srand(stepSeed);
+            int want = ref_add_player(ref, playerId);
+            EXPECT(got == want, "krok %u: add_player(%d) %d != %d", step, playerId, got, want);
+        } else if (op == 1) {
+            int slot = next_byte(&in) % (maxSnakes + 1);  // Aj neplatný slot
+            int permanent = next_byte(&in) & 1;
+            game_remove_player(engine, slot, permanent);
+            ref_remove_player(ref, slot, permanent);
+        } else if (op == 2) {
+            client_input_t input;
+            memset(&input, 0, sizeof(input));
+            input.playerId = next_byte(&in) % FUZZ_PLAYER_IDS;
+            input.action = (action_t)(next_byte(&in) % (ACTION_LIST_GAMES + 1));
+            input.direction = (direction_t)(next_byte(&in) % (DIR_NONE + 2));  // Aj neplatný smer
+            game_process_input(engine, input.playerId, &input);
+            ref_process_input(ref, input.playerId, &input);
+        } else {
+            int ticks = op == 3 ? 1 : 1 + next_byte(&in) % FUZZ_MAX_BURST;
+            for (int t = 0; t < ticks; t++, tick++) {
+                srand(stepSeed + (unsigned)t);
+                game_tick(engine);
+                srand(stepSeed + (unsigned)t);
+                ref_tick(ref);
+                if (compare_states() < 0) {
+                    char prefix[48];
+                    snprintf(prefix, sizeof(prefix), "krok %u, tick %d: ", step, tick);
+                    prefix_failure(prefix);
+                    return -1;
+                }
+            }
+            continue;
+        }
+        if (compare_states() < 0) {
+            char prefix[48];
+            snprintf(prefix, sizeof(prefix), "krok %u (op %d): ", step, op);
+            prefix_failure(prefix);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int fuzz_setup(void) {
+    if (engine) return 0;
+    engine = malloc(sizeof(*engine));
+    ref = malloc(sizeof(*ref));
+    if (!engine || !ref) return -1;
+    return 0;
+}
+
+#ifdef FUZZ_LIBFUZZER
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    if (fuzz_setup() < 0) abort();
+    if (run_case(data, size) < 0) {
+        fprintf(stderr, "Engine sa líši od referencie: %s\n", failure);
+        abort();
+    }
+    return 0;
+}
+
+#else
+
+// Deterministický generátor prípadov (xorshift32)
+static unsigned rng_next(unsigned *state) {
+    unsigned x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+static int run_file(const char *path) {
+    static uint8_t buf[FUZZ_MAX_INPUT];
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    size_t size = fread(buf, 1, sizeof(buf), f);
+    fclose(f);
+    if (run_case(buf, size) < 0) {
+        fprintf(stderr, "%s: engine sa líši od referencie: %s\n", path, failure);
+        return -1;
+    }
+    return 0;
+}
+
+// Spustí súbor alebo všetky súbory v adresári (korpus), vráti počet chýb
+static int run_path(const char *path, int *cases) {
+    struct stat st;
+    if (stat(path, &st) < 0) {
+        perror(path);
+        return 1;
+    }
+    if (!S_ISDIR(st.st_mode)) {
+        (*cases)++;
+        return run_file(path) < 0;
+    }
+    DIR *dir = opendir(path);
+    if (!dir) {
+        perror(path);
+        return 1;
+    }
+    int failures = 0;
+    struct dirent *e;
+    char full[4096];
+    while ((e = readdir(dir)) != NULL) {
+        if (e->d_name[0] == '.') continue;
+        snprintf(full, sizeof(full), "%s/%s", path, e->d_name);
+        failures += run_path(full, cases);
+    }
+    closedir(dir);
+    return failures;
+}
+
+// Zapíše vygenerovaný prípad do korpusu (seed pre libFuzzer)
+static void save_case(const char *dir, int index, const uint8_t *data, size_t size) {
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/gen-%05d", dir, index);
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        perror(path);
+        return;
+    }
+    fwrite(data, 1, size, f);
+    fclose(f);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [-n cases] [-s seed] [-t threads] [-o dir] [corpus...]\n", prog);
+    fprintf(stderr, "  -n N     počet generovaných prípadov (predvolene 2000, 0 = iba korpus)\n");
+    fprintf(stderr, "  -s SEED  seed generátora (rovnaký seed = rovnaké prípady)\n");
+    fprintf(stderr, "  -t N     vlákna pre paralelnú fázu ticku (game_set_tick_threads)\n");
+    fprintf(stderr, "  -o DIR   ulož generované prípady do DIR\n");
+}
+
+int main(int argc, char **argv) {
+    int cases = 2000;
+    unsigned seed = 1;
+    const char *outDir = NULL;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:s:t:o:h")) != -1) {
+        switch (opt) {
+            case 'n':
+                cases = atoi(optarg);
+                break;
+            case 's':
+                seed = (unsigned)strtoul(optarg, NULL, 0);
+                if (seed == 0) seed = 1;
+                break;
+            case 't':
+                game_set_tick_threads(atoi(optarg));
+                break;
+            case 'o':
+                outDir = optarg;
+                break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+    if (fuzz_setup() < 0) {
+        perror("fuzz setup");
+        return 1;
+    }
+
+    int failures = 0;
+    int ran = 0;
+    for (int a = optind; a < argc; a++) {
+        failures += run_path(argv[a], &ran);
+    }
+
+    static uint8_t buf[FUZZ_MAX_INPUT];
+    unsigned rng = seed;
+    for (int c = 0; c < cases; c++) {
+        size_t size = 7 + rng_next(&rng) % 1024;
+        for (size_t b = 0; b < size; b++) buf[b] = (uint8_t)rng_next(&rng);
+        // Väčšina prípadov v menších arénach, kde sa hadíci stretávajú
+        if (c % 4 != 0) {
+            buf[0] %= 24;
+            buf[1] %= 16;
+            buf[2] %= 12;
+        }
+        if (outDir) save_case(outDir, c, buf, size);
+        ran++;
+        if (run_case(buf, size) < 0) {
+            fprintf(stderr, "prípad %d (seed %u): engine sa líši od referencie: %s\n", c, seed, failure);
+            failures++;
+        }
+    }
+
+    fprintf(stderr, "%d prípadov, %d rozdielov\n", ran, failures);
+    fprintf(stderr, "varianty ticku:");
+    for (int k = 0; k < TICK_KERNEL_COUNT; k++) {
+        fprintf(stderr, " %s %d", game_tick_kernel_name((tick_kernel_t)k), kernelCases[k]);
+    }
+    fprintf(stderr, "\n");
+    return failures ? 1 : 0;
+}
+
+#endif
@@ -1,7 +1,80 @@
 #include "game.h"
+#include "trace.h"
+#include <pthread.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define TICK_MAX_THREADS 16
+#define TICK_QUEUE_SIZE 64
+#define PARALLEL_TICK_MIN_SNAKES 128  // Pod touto hranicou sa fáza 1 nedelí medzi vlákna
+#define PARALLEL_TICK_CHUNK 64
+#define CLAIM_TABLE_SIZE (2 * ENGINE_LANES)
+#define SMALL_MAX_SNAKES 32           // Varianty *_SMALL (jedno slovo masiek); pri viac hadíkoch vyhrá SIMD fáza 1
+#define IS_POW2(n) ((n) > 0 && ((n) & ((n) - 1)) == 0)
+
+// Krok hlavy pre DIR_UP, DIR_DOWN, DIR_LEFT, DIR_RIGHT, DIR_NONE
+static const int dirStepX[] = {0, 0, -1, 1, 0};
+static const int dirStepY[] = {-1, 1, 0, 0, 0};
+
+// Výsledok fázy 1: nová hlava každého slotu a či narazí do tela
+typedef struct TickPlan {
+    int nextX[ENGINE_LANES];
+    int nextY[ENGINE_LANES];
+    uint8_t blocked[ENGINE_LANES];
+} tick_plan_t;
+
+typedef struct TickBatch {
+    int pending;
+} tick_batch_t;
+
+typedef struct TickJob {
+    const game_engine_t *state;
+    tick_plan_t *plan;
+    int from;
+    int to;
+    tick_batch_t *batch;
+} tick_job_t;
+
+static pthread_mutex_t poolMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t poolWork = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t poolDone = PTHREAD_COND_INITIALIZER;
+static tick_job_t poolQueue[TICK_QUEUE_SIZE];
+static int queueHead = 0;
+static int queueLen = 0;
+static int poolThreads = 0;
+
+static int slot_test(const uint64_t *mask, int i) {
+    return (int)((mask[i >> 6] >> (i & 63)) & 1u);
+}
+
+static void slot_set(uint64_t *mask, int i) {
+    mask[i >> 6] |= 1ull << (i & 63);
+}
+
+static void slot_clear(uint64_t *mask, int i) {
+    mask[i >> 6] &= ~(1ull << (i & 63));
+}
+
+static int mask_count(const uint64_t *mask) {
+    int count = 0;
+    for (int w = 0; w < ENGINE_MASK_WORDS; w++) {
+        count += __builtin_popcountll(mask[w]);
+    }
+    return count;
+}
+
+// Počet slotov spracovaných SIMD kernelom (zaokrúhlené na 8)
+static int lanes_in_use(const game_engine_t *state) {
+    return (state->maxSnakes + 7) & ~7;
+}
+
 static int rand_between(int min, int max) {
     return min + rand() % (max - min + 1);
 }
@@ -10,34 +83,55 @@ static int positions_equal(position_t a, position_t b) {
     return a.x == b.x && a.y == b.y;
 }
 
-static int active_players(const game_state_t *state) {
-    int alive = 0;
-    for (int i = 0; i < MAX_PLAYERS; i++) {
-        if (state->snakes[i].alive) alive++;
+static int cell_index(const game_engine_t *state, position_t p) {
+    return p.y * state->width + p.x;
+}
+
+// k-ty článok tela (0 = hlava) v kruhovom bufferi
+static position_t *body_cell(game_engine_t *state, int idx, int k) {
+    int pos = state->bodyStart[idx] + k;
+    if (pos >= MAX_SNAKE_LENGTH) pos -= MAX_SNAKE_LENGTH;
+    return &state->body[idx][pos];
+}
+
+static const position_t *body_cell_const(const game_engine_t *state, int idx, int k) {
+    int pos = state->bodyStart[idx] + k;
+    if (pos >= MAX_SNAKE_LENGTH) pos -= MAX_SNAKE_LENGTH;
+    return &state->body[idx][pos];
+}
+
+// Pridá (delta=1) alebo odoberie (delta=-1) celé telo z mriežky
+static void body_to_cells(game_engine_t *state, int idx, int delta) {
+    for (int k = 0; k < state->length[idx]; k++) {
+        state->cells[cell_index(state, *body_cell(state, idx, k))] += (uint8_t)delta;
     }
-    return alive;
 }
 
-static int cell_occupied(const game_state_t *state, position_t p) {
-    for (int i = 0; i < MAX_PLAYERS; i++) {
-        if (!state->snakes[i].alive) continue;
-        for (int j = 0; j < state->snakes[i].length; j++) {
-            if (positions_equal(state->snakes[i].body[j], p)) return 1;
+static int active_players(const game_engine_t *state) {
+    return mask_count(state->aliveMask);
+}
+
+// Nájde voľné políčko, vráti 0 alebo -1 ak je aréna plná
+static int random_free_position(const game_engine_t *state, position_t *out) {
+    int area = state->width * state->height;
+    for (int attempt = 0; attempt < 4 * area; attempt++) {
+        position_t p;
+        p.x = rand_between(0, state->width - 1);
+        p.y = rand_between(0, state->height - 1);
+        if (!state->cells[cell_index(state, p)]) {
+            *out = p;
+            return 0;
         }
     }
-    for (int f = 0; f < state->foodCount; f++) {
-        if (positions_equal(state->food[f], p)) return 1;
+    // Takmer plná aréna - prejdi ju celú
+    for (int c = 0; c < area; c++) {
+        if (!state->cells[c]) {
+            out->x = c % state->width;
+            out->y = c / state->width;
+            return 0;
+        }
     }
-    return 0;
-}
-
-static position_t random_free_position(const game_state_t *state) {
-    position_t p;
-    do {
-        p.x = rand_between(0, WORLD_WIDTH - 1);
-        p.y = rand_between(0, WORLD_HEIGHT - 1);
-    } while (cell_occupied(state, p));
-    return p;
+    return -1;
 }
 
 static int opposite(direction_t a, direction_t b) {
@@ -45,125 +139,356 @@ static int opposite(direction_t a, direction_t b) {
            (a == DIR_LEFT && b == DIR_RIGHT) || (a == DIR_RIGHT && b == DIR_LEFT);
 }
 
-static void spawn_food_if_needed(game_state_t *state) {
+static void set_direction(game_engine_t *state, int idx, direction_t dir) {
+    state->direction[idx] = dir;
+    state->stepX[idx] = dirStepX[dir];
+    state->stepY[idx] = dirStepY[dir];
+}
+
+// Hadík zomrie; jeho telo prestane byť prekážkou
+static void kill_snake(game_engine_t *state, int idx) {
+    if (!slot_test(state->aliveMask, idx)) return;
+    slot_clear(state->aliveMask, idx);
+    body_to_cells(state, idx, -1);
+}
+
+static void spawn_food_if_needed(game_engine_t *state) {
     int target = active_players(state);
     if (target < 1) target = 1; // aspoň jedno ovocie, ak hra beží
-    while (state->foodCount < target && state->foodCount < MAX_PLAYERS * 2) {
-        state->food[state->foodCount++] = random_free_position(state);
+    while (state->foodCount < target && state->foodCount < ENGINE_MAX_FOOD) {
+        position_t p;
+        if (random_free_position(state, &p) < 0) break;
+        state->food[state->foodCount++] = p;
+        state->cells[cell_index(state, p)] |= CELL_FOOD;
+    }
+}
+
+static void eat_food_at(game_engine_t *state, position_t p) {
+    state->cells[cell_index(state, p)] &= (uint8_t)~CELL_FOOD;
+    for (int f = 0; f < state->foodCount; f++) {
+        if (positions_equal(p, state->food[f])) {
+            state->food[f] = state->food[state->foodCount - 1];
+            state->foodCount--;
+            return;
+        }
     }
 }
 
-static void move_snake(game_state_t *state, snake_t *s) {
-    if (!s->alive || s->paused) return;
+// Nové pozície hláv slotov [from, to); wraparound porovnaním namiesto %,
+// pri rozmeroch mocniny dvojky (pow2) maskou
+static void advance_heads(const game_engine_t *state, int *nextX, int *nextY, int from, int to, int pow2) {
+#if defined(__AVX2__)
+    if (pow2) {
+        const __m256i wMask = _mm256_set1_epi32(state->width - 1);
+        const __m256i hMask = _mm256_set1_epi32(state->height - 1);
+        for (int i = from; i < to; i += 8) {
+            __m256i x = _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)&state->headX[i]),
+                                         _mm256_loadu_si256((const __m256i *)&state->stepX[i]));
+            __m256i y = _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)&state->headY[i]),
+                                         _mm256_loadu_si256((const __m256i *)&state->stepY[i]));
+            _mm256_storeu_si256((__m256i *)&nextX[i], _mm256_and_si256(x, wMask));
+            _mm256_storeu_si256((__m256i *)&nextY[i], _mm256_and_si256(y, hMask));
+        }
+        return;
+    }
 
-    position_t head = s->body[0];
-    switch (s->direction) {
-        case DIR_UP:    head.y = (head.y - 1 + WORLD_HEIGHT) % WORLD_HEIGHT; break;
-        case DIR_DOWN:  head.y = (head.y + 1) % WORLD_HEIGHT; break;
-        case DIR_LEFT:  head.x = (head.x - 1 + WORLD_WIDTH) % WORLD_WIDTH; break;
-        case DIR_RIGHT: head.x = (head.x + 1) % WORLD_WIDTH; break;
-        default: break;
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i w = _mm256_set1_epi32(state->width);
+    const __m256i h = _mm256_set1_epi32(state->height);
+    const __m256i wMax = _mm256_set1_epi32(state->width - 1);
+    const __m256i hMax = _mm256_set1_epi32(state->height - 1);
+    for (int i = from; i < to; i += 8) {
+        __m256i x = _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)&state->headX[i]),
+                                     _mm256_loadu_si256((const __m256i *)&state->stepX[i]));
+        __m256i y = _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)&state->headY[i]),
+                                     _mm256_loadu_si256((const __m256i *)&state->stepY[i]));
+        x = _mm256_add_epi32(x, _mm256_and_si256(_mm256_cmpgt_epi32(zero, x), w));
+        x = _mm256_sub_epi32(x, _mm256_and_si256(_mm256_cmpgt_epi32(x, wMax), w));
+        y = _mm256_add_epi32(y, _mm256_and_si256(_mm256_cmpgt_epi32(zero, y), h));
+        y = _mm256_sub_epi32(y, _mm256_and_si256(_mm256_cmpgt_epi32(y, hMax), h));
+        _mm256_storeu_si256((__m256i *)&nextX[i], x);
+        _mm256_storeu_si256((__m256i *)&nextY[i], y);
+    }
+#elif defined(__SSE2__)
+    if (pow2) {
+        const __m128i wMask = _mm_set1_epi32(state->width - 1);
+        const __m128i hMask = _mm_set1_epi32(state->height - 1);
+        for (int i = from; i < to; i += 4) {
+            __m128i x = _mm_add_epi32(_mm_loadu_si128((const __m128i *)&state->headX[i]),
+                                      _mm_loadu_si128((const __m128i *)&state->stepX[i]));
+            __m128i y = _mm_add_epi32(_mm_loadu_si128((const __m128i *)&state->headY[i]),
+                                      _mm_loadu_si128((const __m128i *)&state->stepY[i]));
+            _mm_storeu_si128((__m128i *)&nextX[i], _mm_and_si128(x, wMask));
+            _mm_storeu_si128((__m128i *)&nextY[i], _mm_and_si128(y, hMask));
+        }
+        return;
+    }
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i w = _mm_set1_epi32(state->width);
+    const __m128i h = _mm_set1_epi32(state->height);
+    const __m128i wMax = _mm_set1_epi32(state->width - 1);
+    const __m128i hMax = _mm_set1_epi32(state->height - 1);
+    for (int i = from; i < to; i += 4) {
+        __m128i x = _mm_add_epi32(_mm_loadu_si128((const __m128i *)&state->headX[i]),
+                                  _mm_loadu_si128((const __m128i *)&state->stepX[i]));
+        __m128i y = _mm_add_epi32(_mm_loadu_si128((const __m128i *)&state->headY[i]),
+                                  _mm_loadu_si128((const __m128i *)&state->stepY[i]));
+        x = _mm_add_epi32(x, _mm_and_si128(_mm_cmplt_epi32(x, zero), w));
+        x = _mm_sub_epi32(x, _mm_and_si128(_mm_cmpgt_epi32(x, wMax), w));
+        y = _mm_add_epi32(y, _mm_and_si128(_mm_cmplt_epi32(y, zero), h));
+        y = _mm_sub_epi32(y, _mm_and_si128(_mm_cmpgt_epi32(y, hMax), h));
+        _mm_storeu_si128((__m128i *)&nextX[i], x);
+        _mm_storeu_si128((__m128i *)&nextY[i], y);
     }
+#else
+    if (pow2) {
+        for (int i = from; i < to; i++) {
+            nextX[i] = (state->headX[i] + state->stepX[i]) & (state->width - 1);
+            nextY[i] = (state->headY[i] + state->stepY[i]) & (state->height - 1);
+        }
+        return;
+    }
+    for (int i = from; i < to; i++) {
+        int x = state->headX[i] + state->stepX[i];
+        int y = state->headY[i] + state->stepY[i];
+        if (x < 0) x += state->width;
+        else if (x >= state->width) x -= state->width;
+        if (y < 0) y += state->height;
+        else if (y >= state->height) y -= state->height;
+        nextX[i] = x;
+        nextY[i] = y;
+    }
+#endif
+}
 
-    // kolízia s telom alebo inými hadmi
-    for (int i = 0; i < MAX_PLAYERS; i++) {
-        if (!state->snakes[i].alive) continue;
-        int len = state->snakes[i].length;
-        for (int j = 0; j < len; j++) {
-            if (positions_equal(head, state->snakes[i].body[j])) {
-                s->alive = 0;
-                return;
-            }
+// Fáza 1 pre sloty [from, to): stav iba číta, píše len do vlastnej časti plánu
+static void tick_compute(const game_engine_t *state, tick_plan_t *plan, int from, int to) {
+    if (state->tickKernel == TICK_KERNEL_POW2) {
+        int shift = __builtin_ctz((unsigned)state->width);
+        advance_heads(state, plan->nextX, plan->nextY, from, to, 1);
+        for (int i = from; i < to; i++) {
+            plan->blocked[i] = (state->cells[(plan->nextY[i] << shift) | plan->nextX[i]] & CELL_BODY_MASK) != 0;
         }
+        return;
     }
+    advance_heads(state, plan->nextX, plan->nextY, from, to, 0);
+    for (int i = from; i < to; i++) {
+        int cell = plan->nextY[i] * state->width + plan->nextX[i];
+        plan->blocked[i] = (state->cells[cell] & CELL_BODY_MASK) != 0;
+    }
+}
 
-    int ate = 0;
-    for (int f = 0; f < state->foodCount; f++) {
-        if (positions_equal(head, state->food[f])) {
-            ate = 1;
-            s->score += 10;
-            state->food[f] = state->food[state->foodCount - 1];
-            state->foodCount--;
+static void run_job(const tick_job_t *job) {
+    int64_t t0 = trace_begin();
+    tick_compute(job->state, job->plan, job->from, job->to);
+    trace_end("tick.compute_chunk", t0);
+}
+
+static void *tick_worker(void *arg) {
+    (void)arg;
+    trace_thread_name("tick worker");
+    pthread_mutex_lock(&poolMutex);
+    while (1) {
+        while (queueLen == 0) {
+            pthread_cond_wait(&poolWork, &poolMutex);
+        }
+        tick_job_t job = poolQueue[queueHead];
+        queueHead = (queueHead + 1) % TICK_QUEUE_SIZE;
+        queueLen--;
+        pthread_mutex_unlock(&poolMutex);
+
+        run_job(&job);
+
+        pthread_mutex_lock(&poolMutex);
+        if (--job.batch->pending == 0) {
+            pthread_cond_broadcast(&poolDone);
+        }
+    }
+    return NULL;
+}
+
+void game_set_tick_threads(int threads) {
+    if (threads > TICK_MAX_THREADS) threads = TICK_MAX_THREADS;
+    pthread_mutex_lock(&poolMutex);
+    while (poolThreads < threads) {
+        pthread_t tid;
+        if (pthread_create(&tid, NULL, tick_worker, NULL) != 0) break;
+        pthread_detach(tid);
+        poolThreads++;
+    }
+    pthread_mutex_unlock(&poolMutex);
+}
+
+// Fáza 1 celej arény; veľké arény sa delia na bloky pre pool vlákien
+static void run_compute(const game_engine_t *state, tick_plan_t *plan, int movers) {
+    int lanes = lanes_in_use(state);
+    if (poolThreads == 0 || movers < PARALLEL_TICK_MIN_SNAKES || lanes <= PARALLEL_TICK_CHUNK) {
+        tick_compute(state, plan, 0, lanes);
+        return;
+    }
+
+    tick_batch_t batch;
+    batch.pending = 0;
+    int inlineFrom = lanes;
+
+    pthread_mutex_lock(&poolMutex);
+    for (int from = PARALLEL_TICK_CHUNK; from < lanes; from += PARALLEL_TICK_CHUNK) {
+        if (queueLen == TICK_QUEUE_SIZE) {
+            inlineFrom = from; // Plná fronta - zvyšok spraví volajúci
             break;
         }
+        tick_job_t *job = &poolQueue[(queueHead + queueLen) % TICK_QUEUE_SIZE];
+        job->state = state;
+        job->plan = plan;
+        job->from = from;
+        job->to = from + PARALLEL_TICK_CHUNK < lanes ? from + PARALLEL_TICK_CHUNK : lanes;
+        job->batch = &batch;
+        queueLen++;
+        batch.pending++;
     }
+    pthread_cond_broadcast(&poolWork);
+    pthread_mutex_unlock(&poolMutex);
+
+    tick_compute(state, plan, 0, PARALLEL_TICK_CHUNK);
+    if (inlineFrom < lanes) tick_compute(state, plan, inlineFrom, lanes);
 
-    // posun tela
-    for (int i = s->length; i > 0; i--) {
-        s->body[i] = s->body[i - 1];
+    // Kým čakáme, pomáhame s frontou (aj s blokmi iných hier)
+    pthread_mutex_lock(&poolMutex);
+    while (batch.pending > 0) {
+        if (queueLen > 0) {
+            tick_job_t job = poolQueue[queueHead];
+            queueHead = (queueHead + 1) % TICK_QUEUE_SIZE;
+            queueLen--;
+            pthread_mutex_unlock(&poolMutex);
+            run_job(&job);
+            pthread_mutex_lock(&poolMutex);
+            if (--job.batch->pending == 0) {
+                pthread_cond_broadcast(&poolDone);
+            }
+        } else {
+            pthread_cond_wait(&poolDone, &poolMutex);
+        }
+    }
+    pthread_mutex_unlock(&poolMutex);
+}
+
+// 1 ak variant zvládne rozmery a kapacitu hadíkov hry
+static int kernel_fits(const game_engine_t *state, tick_kernel_t kernel) {
+    int small = state->maxSnakes <= SMALL_MAX_SNAKES;
+    int pow2 = IS_POW2(state->width) && IS_POW2(state->height);
+    switch (kernel) {
+        case TICK_KERNEL_GENERIC:
+            return 1;
+        case TICK_KERNEL_SMALL:
+            return small;
+        case TICK_KERNEL_POW2:
+            return pow2;
+        case TICK_KERNEL_POW2_SMALL:
+            return pow2 && small;
+        case TICK_KERNEL_CLASSIC:
+            return small && state->width == WORLD_WIDTH && state->height == WORLD_HEIGHT;
+        default:
+            return 0;
     }
-    s->body[0] = head;
-    if (ate && s->length < MAX_SNAKE_LENGTH) {
-        s->length++;
+}
+
+// Najšpecializovanejší variant, ktorý hre sedí
+static void select_tick_kernel(game_engine_t *state) {
+    static const tick_kernel_t preference[] = {TICK_KERNEL_CLASSIC, TICK_KERNEL_POW2_SMALL, TICK_KERNEL_POW2,
+                                               TICK_KERNEL_SMALL};
+    state->tickKernel = TICK_KERNEL_GENERIC;
+    for (size_t k = 0; k < sizeof(preference) / sizeof(preference[0]); k++) {
+        if (kernel_fits(state, preference[k])) {
+            state->tickKernel = preference[k];
+            return;
+        }
     }
 }
 
-void game_init(game_state_t *state) {
-    memset(state, 0, sizeof(*state));
+static void clear_cells(game_engine_t *state) {
+    memset(state->cells, 0, (size_t)state->width * (size_t)state->height);
+    memset(state->claimBits, 0, sizeof(state->claimBits));
+}
+
+void game_init(game_engine_t *state) {
+    // Studené polia sa inicializujú až pri použití
+    memset(state, 0, offsetof(game_engine_t, cells));
+    state->width = WORLD_WIDTH;
+    state->height = WORLD_HEIGHT;
+    state->maxSnakes = MAX_PLAYERS;
+    select_tick_kernel(state);
     state->gameRunning = 0;
     // Inicializuj player_id na -1 (označuje voľné miesto)
-    for (int i = 0; i < MAX_PLAYERS; i++) {
-        state->snakes[i].playerId = -1;
+    for (int i = 0; i < ENGINE_LANES; i++) {
+        state->playerId[i] = -1;
     }
+    clear_cells(state);
 }
 
-void game_reset(game_state_t *state) {
-    int oldGameId = state->gameId;  // Ulož gameId pred resetom
-    state->gameRunning = 0;
-    state->playerCount = 0;
+int game_configure(game_engine_t *state, int width, int height, int maxSnakes) {
+    if (width < 3 || width > ARENA_MAX_WIDTH || height < 1 || height > ARENA_MAX_HEIGHT) return -1;
+    if (maxSnakes < 1 || maxSnakes > ARENA_MAX_SNAKES) return -1;
+    if (game_used_slots(state) > 0) return -1;
+    state->width = width;
+    state->height = height;
+    state->maxSnakes = maxSnakes;
+    select_tick_kernel(state);
     state->foodCount = 0;
-    state->elapsedTime = 0;
-    memset(state->snakes, 0, sizeof(state->snakes));
-    memset(state->food, 0, sizeof(state->food));
-    // Resetuj player_id na -1
-    for (int i = 0; i < MAX_PLAYERS; i++) {
-        state->snakes[i].playerId = -1;
-    }
+    clear_cells(state);
+    return 0;
+}
+
+void game_reset(game_engine_t *state) {
+    int oldGameId = state->gameId;  // Ulož gameId pred resetom
+    game_init(state);
     state->gameId = oldGameId;  // Obnov gameId
 }
 
-int game_add_player(game_state_t *state, int playerId) {
+int game_add_player(game_engine_t *state, int playerId) {
     int idx = -1;
     // Skontroluj, či hráč už v hre existuje
-    for (int i = 0; i < MAX_PLAYERS; i++) {
-        if (state->snakes[i].playerId == playerId && state->snakes[i].alive) {
+    for (int i = 0; i < state->maxSnakes; i++) {
+        if (state->playerId[i] == playerId && slot_test(state->aliveMask, i)) {
             return i; // Hráč už existuje a žije
         }
     }
-    
+
     // Skontroluj, či hráč zomrel v tejto hre - ak áno, vráť -2
-    for (int i = 0; i < MAX_PLAYERS; i++) {
-        if (state->snakes[i].playerId == playerId && !state->snakes[i].alive) {
+    for (int i = 0; i < state->maxSnakes; i++) {
+        if (state->playerId[i] == playerId && !slot_test(state->aliveMask, i)) {
             return -2; // Hráč je mŕtvy - nedovoľ reconnect
         }
     }
-    
+
     // Hľadaj voľné miesto
-    for (int i = 0; i < MAX_PLAYERS; i++) {
-        if (state->snakes[i].playerId == -1) {  // Voľný slot
+    for (int i = 0; i < state->maxSnakes; i++) {
+        if (!slot_test(state->usedMask, i)) {  // Voľný slot
             idx = i;
             break;
         }
     }
 
-    if (idx == -1) {
+    position_t head;
+    if (idx == -1 || random_free_position(state, &head) < 0) {
         return -1; // Plná hra
     }
 
-    snake_t *s = &state->snakes[idx];
-    memset(s, 0, sizeof(*s));
-
-    s->playerId = playerId;  // Použij podaný playerId
-    s->length = 3;
-    s->direction = DIR_RIGHT;
-    s->score = 0;
-    s->alive = 1;
-    s->paused = 0;
+    state->playerId[idx] = playerId;  // Použij podaný playerId
+    state->length[idx] = 3;
+    set_direction(state, idx, DIR_RIGHT);
+    state->score[idx] = 0;
+    slot_set(state->usedMask, idx);
+    slot_set(state->aliveMask, idx);
+    slot_clear(state->pausedMask, idx);
 
-    position_t head = random_free_position(state);
-    s->body[0] = head;
-    s->body[1] = (position_t){(head.x - 1 + WORLD_WIDTH) % WORLD_WIDTH, head.y};
-    s->body[2] = (position_t){(head.x - 2 + WORLD_WIDTH) % WORLD_WIDTH, head.y};
+    position_t *body = state->body[idx];
+    state->bodyStart[idx] = 0;
+    body[0] = head;
+    body[1] = (position_t){(head.x - 1 + state->width) % state->width, head.y};
+    body[2] = (position_t){(head.x - 2 + state->width) % state->width, head.y};
+    state->headX[idx] = head.x;
+    state->headY[idx] = head.y;
+    body_to_cells(state, idx, 1);
 
     state->playerCount++;  // Zvýš počet hráčov
     state->gameRunning = 1;
@@ -171,69 +496,313 @@ int game_add_player(game_state_t *state, int playerId) {
     return idx;
 }
 
-void game_remove_player(game_state_t *state, int playerIdx, int permanent) {
-    if (playerIdx < 0 || playerIdx >= MAX_PLAYERS) return;
-    if (state->snakes[playerIdx].playerId == -1) return;  // Už je voľný slot
-    
-    printf("Removing player %d from game %d (permanent=%d)\n", playerIdx, state->gameId, permanent);
-    
+void game_remove_player(game_engine_t *state, int playerIdx, int permanent) {
+    if (playerIdx < 0 || playerIdx >= state->maxSnakes) return;
+    if (!slot_test(state->usedMask, playerIdx)) return;  // Už je voľný slot
+
     // Zníž player_count iba ak bol hráč živý
-    if (state->snakes[playerIdx].alive && state->playerCount > 0) {
+    if (slot_test(state->aliveMask, playerIdx) && state->playerCount > 0) {
         state->playerCount--;
     }
-    
+
+    kill_snake(state, playerIdx);
+    slot_clear(state->pausedMask, playerIdx);
     if (permanent) {
         // Úplné resetovanie - oslobodi slot pre ďalšieho hráča
-        memset(&state->snakes[playerIdx], 0, sizeof(snake_t));
-        state->snakes[playerIdx].playerId = -1;  // Označí slot ako voľný
-    } else {
-        // Mrtvy hráč - označí ako mŕtveho, ale nechá player_id
-        state->snakes[playerIdx].alive = 0;
-        state->snakes[playerIdx].paused = 0;
+        slot_clear(state->usedMask, playerIdx);
+        state->playerId[playerIdx] = -1;  // Označí slot ako voľný
+        state->length[playerIdx] = 0;
+        state->score[playerIdx] = 0;
+        state->headX[playerIdx] = 0;
+        state->headY[playerIdx] = 0;
+        set_direction(state, playerIdx, DIR_UP);
     }
 }
 
-void game_process_input(game_state_t *state, int playerId, const client_input_t *input) {
+void game_process_input(game_engine_t *state, int playerId, const client_input_t *input) {
     if (!input) return;
-    
+
     // Nájdi hadíka s daným player_id
     int player_idx = -1;
-    for (int i = 0; i < MAX_PLAYERS; i++) {
-        if (state->snakes[i].playerId == playerId) {
+    for (int i = 0; i < state->maxSnakes; i++) {
+        if (state->playerId[i] == playerId) {
             player_idx = i;
             break;
         }
     }
-    
+
     if (player_idx < 0) return;  // Hráč neexistuje
-    
-    snake_t *s = &state->snakes[player_idx];
-    if (!s->alive) return;
+    if (!slot_test(state->aliveMask, player_idx)) return;
 
     switch (input->action) {
         case ACTION_MOVE:
-            if (!opposite(s->direction, input->direction)) {
-                s->direction = input->direction;
+            if ((unsigned)input->direction <= DIR_NONE &&
+                !opposite(state->direction[player_idx], input->direction)) {
+                set_direction(state, player_idx, input->direction);
             }
-            s->paused = 0; // Resume on move
+            slot_clear(state->pausedMask, player_idx); // Resume on move
             break;
         case ACTION_QUIT:
-            s->alive = 0;
+            kill_snake(state, player_idx);
             break;
         case ACTION_PAUSE:
-            s->paused = !s->paused; // Toggle pause
+            if (slot_test(state->pausedMask, player_idx)) { // Toggle pause
+                slot_clear(state->pausedMask, player_idx);
+            } else {
+                slot_set(state->pausedMask, player_idx);
+            }
             break;
         default:
             break;
     }
 }
 
-void game_tick(game_state_t *state) {
-    for (int i = 0; i < MAX_PLAYERS; i++) {
-        move_snake(state, &state->snakes[i]);
+// Šablóna ticku. Varianty ju volajú s konštantami, ktoré kompilátor zapečie:
+// W/H > 0 sú rozmery známe pri preklade (0 = zo stavu), POW2 = wraparound
+// maskou a index posunom, WORDS = počet slov masiek slotov. S jedným slovom
+// sa fáza 1 počíta iba pre pohybujúce sa sloty, bez SIMD a vlákien, a čelné
+// zrážky sa hľadajú v bitovej mape políčok namiesto hašovacej tabuľky,
+// ktorú by bolo treba v každom ticku nulovať.
+static inline __attribute__((always_inline)) void tick_kernel(game_engine_t *state, const int W, const int H,
+                                                              const int POW2, const int WORDS) {
+    const int width = W ? W : state->width;
+    const int height = H ? H : state->height;
+    const int shift = POW2 ? __builtin_ctz((unsigned)width) : 0;
+#define KERNEL_CELL(x, y) (POW2 ? ((y) << shift) | (x) : (y) * width + (x))
+
+    uint64_t movers[ENGINE_MASK_WORDS];
+    for (int w = 0; w < WORDS; w++) {
+        movers[w] = state->aliveMask[w] & ~state->pausedMask[w];
+    }
+
+    // Fáza 1: nové hlavy a kolízie voči mriežke pred tickom
+    int64_t t0 = trace_begin();
+    tick_plan_t plan;
+    if (WORDS == 1) {
+        uint64_t bits = movers[0];
+        while (bits) {
+            int i = __builtin_ctzll(bits);
+            bits &= bits - 1;
+            int x = state->headX[i] + state->stepX[i];
+            int y = state->headY[i] + state->stepY[i];
+            if (POW2) {
+                x &= width - 1;
+                y &= height - 1;
+            } else {
+                if (x < 0) x += width;
+                else if (x >= width) x -= width;
+                if (y < 0) y += height;
+                else if (y >= height) y -= height;
+            }
+            plan.nextX[i] = x;
+            plan.nextY[i] = y;
+            plan.blocked[i] = (state->cells[KERNEL_CELL(x, y)] & CELL_BODY_MASK) != 0;
+        }
+    } else {
+        run_compute(state, &plan, mask_count(movers));
+    }
+    trace_end("tick.move_compute", t0);
+
+    // Fáza 2a: čelné zrážky - viac hadíkov na rovnakom políčku zomrie spolu
+    t0 = trace_begin();
+    uint8_t dies[ENGINE_LANES];
+    if (WORDS == 1) {
+        uint64_t bits = movers[0];
+        while (bits) {
+            int i = __builtin_ctzll(bits);
+            bits &= bits - 1;
+            dies[i] = plan.blocked[i];
+            if (dies[i]) continue;
+
+            int cell = KERNEL_CELL(plan.nextX[i], plan.nextY[i]);
+            uint64_t bit = 1ull << (cell & 63);
+            if (!(state->claimBits[cell >> 6] & bit)) {
+                state->claimBits[cell >> 6] |= bit;
+                continue;
+            }
+            // Políčko už niekto obsadil: zomrie aj každý skorší s rovnakou hlavou
+            dies[i] = 1;
+            uint64_t earlier = movers[0] & ((1ull << i) - 1);
+            while (earlier) {
+                int j = __builtin_ctzll(earlier);
+                earlier &= earlier - 1;
+                if (!plan.blocked[j] && plan.nextX[j] == plan.nextX[i] && plan.nextY[j] == plan.nextY[i]) {
+                    dies[j] = 1;
+                }
+            }
+        }
+        bits = movers[0];
+        while (bits) {
+            int i = __builtin_ctzll(bits);
+            bits &= bits - 1;
+            if (!plan.blocked[i]) state->claimBits[KERNEL_CELL(plan.nextX[i], plan.nextY[i]) >> 6] = 0;
+        }
+    } else {
+        int claimCell[CLAIM_TABLE_SIZE];
+        int claimOwner[CLAIM_TABLE_SIZE];
+        memset(claimCell, 0xff, sizeof(claimCell));
+        for (int w = 0; w < WORDS; w++) {
+            uint64_t bits = movers[w];
+            while (bits) {
+                int i = w * 64 + __builtin_ctzll(bits);
+                bits &= bits - 1;
+                dies[i] = plan.blocked[i];
+                if (dies[i]) continue;
+
+                int cell = KERNEL_CELL(plan.nextX[i], plan.nextY[i]);
+                unsigned h = ((unsigned)cell * 2654435761u) & (CLAIM_TABLE_SIZE - 1);
+                while (claimCell[h] != -1 && claimCell[h] != cell) {
+                    h = (h + 1) & (CLAIM_TABLE_SIZE - 1);
+                }
+                if (claimCell[h] == -1) {
+                    claimCell[h] = cell;
+                    claimOwner[h] = i;
+                } else {
+                    dies[i] = 1;
+                    dies[claimOwner[h]] = 1;
+                }
+            }
+        }
+    }
+
+    // Fáza 2b: najprv úmrtia, potom pohyb preživších (hlavy sú už unikátne)
+    for (int w = 0; w < WORDS; w++) {
+        uint64_t bits = movers[w];
+        while (bits) {
+            int i = w * 64 + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            if (dies[i]) kill_snake(state, i);
+        }
+    }
+    trace_end("tick.collide", t0);
+
+    t0 = trace_begin();
+    for (int w = 0; w < WORDS; w++) {
+        uint64_t bits = movers[w];
+        while (bits) {
+            int i = w * 64 + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            if (dies[i]) continue;
+
+            position_t head = {plan.nextX[i], plan.nextY[i]};
+            int cell = KERNEL_CELL(head.x, head.y);
+            int ate = (state->cells[cell] & CELL_FOOD) != 0;
+            if (ate) {
+                state->score[i] += 10;
+                eat_food_at(state, head);
+            }
+
+            int len = state->length[i];
+            int grow = ate && len < MAX_SNAKE_LENGTH;
+            if (!grow) {
+                const position_t *tail = body_cell(state, i, len - 1);
+                state->cells[KERNEL_CELL(tail->x, tail->y)]--;
+            }
+            state->bodyStart[i] = state->bodyStart[i] == 0 ? MAX_SNAKE_LENGTH - 1 : state->bodyStart[i] - 1;
+            state->body[i][state->bodyStart[i]] = head;
+            state->cells[cell]++;
+            state->headX[i] = head.x;
+            state->headY[i] = head.y;
+            if (grow) state->length[i]++;
+        }
     }
+#undef KERNEL_CELL
+
+    trace_end("tick.eat_move", t0);
+
+    t0 = trace_begin();
     spawn_food_if_needed(state);
-    int alive = active_players(state);
-    state->playerCount = alive; 
+    trace_end("tick.food_spawn", t0);
+
+    t0 = trace_begin();
+    int alive = 0;
+    for (int w = 0; w < WORDS; w++) {
+        alive += __builtin_popcountll(state->aliveMask[w]);
+    }
+    state->playerCount = alive;
     state->gameRunning = alive > 0;
-}
\ No newline at end of file
+    trace_end("tick.alive_count", t0);
+}
+
+static void tick_generic(game_engine_t *state) {
+    tick_kernel(state, 0, 0, 0, ENGINE_MASK_WORDS);
+}
+
+static void tick_small(game_engine_t *state) {
+    tick_kernel(state, 0, 0, 0, 1);
+}
+
+static void tick_pow2(game_engine_t *state) {
+    tick_kernel(state, 0, 0, 1, ENGINE_MASK_WORDS);
+}
+
+static void tick_pow2_small(game_engine_t *state) {
+    tick_kernel(state, 0, 0, 1, 1);
+}
+
+static void tick_classic(game_engine_t *state) {
+    tick_kernel(state, WORLD_WIDTH, WORLD_HEIGHT, IS_POW2(WORLD_WIDTH) && IS_POW2(WORLD_HEIGHT), 1);
+}
+
+static void (*const tickKernels[TICK_KERNEL_COUNT])(game_engine_t *) = {
+    [TICK_KERNEL_GENERIC] = tick_generic,
+    [TICK_KERNEL_SMALL] = tick_small,
+    [TICK_KERNEL_POW2] = tick_pow2,
+    [TICK_KERNEL_POW2_SMALL] = tick_pow2_small,
+    [TICK_KERNEL_CLASSIC] = tick_classic,
+};
+
+static const char *const tickKernelNames[TICK_KERNEL_COUNT] = {
+    [TICK_KERNEL_GENERIC] = "generic",
+    [TICK_KERNEL_SMALL] = "small",
+    [TICK_KERNEL_POW2] = "pow2",
+    [TICK_KERNEL_POW2_SMALL] = "pow2-small",
+    [TICK_KERNEL_CLASSIC] = "classic",
+};
+
+int game_set_tick_kernel(game_engine_t *state, tick_kernel_t kernel) {
+    if (!kernel_fits(state, kernel)) return -1;
+    state->tickKernel = kernel;
+    return 0;
+}
+
+const char *game_tick_kernel_name(tick_kernel_t kernel) {
+    return (unsigned)kernel < TICK_KERNEL_COUNT ? tickKernelNames[kernel] : "?";
+}
+
+void game_tick(game_engine_t *state) {
+    tickKernels[(unsigned)state->tickKernel < TICK_KERNEL_COUNT ? state->tickKernel : TICK_KERNEL_GENERIC](state);
+}
+
+int game_player_alive(const game_engine_t *state, int playerIdx) {
+    if (playerIdx < 0 || playerIdx >= state->maxSnakes) return 0;
+    return slot_test(state->aliveMask, playerIdx);
+}
+
+int game_player_paused(const game_engine_t *state, int playerIdx) {
+    if (playerIdx < 0 || playerIdx >= state->maxSnakes) return 0;
+    return slot_test(state->pausedMask, playerIdx);
+}
+
+position_t game_snake_cell(const game_engine_t *state, int playerIdx, int k) {
+    return *body_cell_const(state, playerIdx, k);
+}
+
+int game_used_slots(const game_engine_t *state) {
+    return mask_count(state->usedMask);
+}
+
+void game_copy(game_engine_t *dst, const game_engine_t *src) {
+    memcpy(dst, src, offsetof(game_engine_t, cells));
+    memcpy(dst->body, src->body, (size_t)src->maxSnakes * sizeof(src->body[0]));
+}
+
+void game_rebuild_cells(game_engine_t *state) {
+    clear_cells(state);
+    for (int i = 0; i < state->maxSnakes; i++) {
+        if (slot_test(state->aliveMask, i)) body_to_cells(state, i, 1);
+    }
+    for (int f = 0; f < state->foodCount; f++) {
+        state->cells[cell_index(state, state->food[f])] |= CELL_FOOD;
+    }
+}
@@ -1,26 +1,130 @@
 #ifndef GAME_H
 #define GAME_H
 
+#include <stdint.h>
 #include "shared.h"
 
-// Inicializuje stav hry na prazdno
-void game_init(game_state_t *state);
+// Limity veľkých arén (klasická hra je WORLD_WIDTH x WORLD_HEIGHT s MAX_PLAYERS hadíkmi)
+#define ARENA_MAX_SNAKES 256
+#define ARENA_MAX_WIDTH 256
+#define ARENA_MAX_HEIGHT 256
+
+// Počet slotov hadíkov v enginoch, násobok 64 kvôli bitovým maskám (a šírke AVX2)
+#define ENGINE_LANES ARENA_MAX_SNAKES
+#define ENGINE_MASK_WORDS (ENGINE_LANES / 64)
+#define ENGINE_MAX_FOOD ENGINE_LANES
+
+#if ENGINE_LANES < MAX_PLAYERS || ENGINE_LANES % 64 != 0
+#error "ENGINE_LANES musí byť násobok 64 a aspoň MAX_PLAYERS"
+#endif
+
+// Bunka mriežky obsadenosti: počet častí tiel na políčku + príznak ovocia
+#define CELL_FOOD 0x80u
+#define CELL_BODY_MASK 0x7Fu
+
+// Varianty ticku špecializované pri preklade. game_init/game_configure vyberú
+// najrýchlejší variant, ktorý rozmerom a kapacite hadíkov zodpovedá; všetky
+// dávajú rovnaký výsledok ako TICK_KERNEL_GENERIC.
+typedef enum TickKernel {
+    TICK_KERNEL_GENERIC,     // Ľubovoľné rozmery a počet hadíkov
+    TICK_KERNEL_SMALL,       // Najviac 32 hadíkov (jedno slovo masiek)
+    TICK_KERNEL_POW2,        // Rozmery mocniny dvojky: wraparound maskou, index posunom
+    TICK_KERNEL_POW2_SMALL,  // Mocniny dvojky a najviac 32 hadíkov
+    TICK_KERNEL_CLASSIC,     // WORLD_WIDTH x WORLD_HEIGHT, najviac 32 hadíkov, rozmery konštanty
+    TICK_KERNEL_COUNT
+} tick_kernel_t;
+
+// Stav hry na serveri v rozložení struct-of-arrays.
+// Horúce polia (čítané v každom ticku) sú súvislé polia indexované slotom,
+// alive/paused/used sú bitové masky. Mriežka obsadenosti a telá hadíkov
+// (kruhové buffre) sú studené a ležia na konci; používa sa iba ich časť
+// podľa width/height/maxSnakes. Klient dostáva iba výrez z aoi_encode_view().
+typedef struct GameEngine {
+    // Rozmery arény
+    int width;
+    int height;
+    int maxSnakes;
+    int tickKernel;                  // tick_kernel_t, vyberá game_configure
+
+    // Horúce polia
+    int headX[ENGINE_LANES];
+    int headY[ENGINE_LANES];
+    int stepX[ENGINE_LANES];         // Krok hlavy podľa smeru (-1, 0, 1)
+    int stepY[ENGINE_LANES];
+    int length[ENGINE_LANES];
+    int bodyStart[ENGINE_LANES];     // Index hlavy v kruhovom bufferi body[i]
+    uint64_t aliveMask[ENGINE_MASK_WORDS];
+    uint64_t pausedMask[ENGINE_MASK_WORDS];
+    uint64_t usedMask[ENGINE_MASK_WORDS];  // Obsadené sloty (playerId != -1)
+
+    int gameId;
+    int elapsedTime;
+    uint32_t tickStampUs;            // Kedy prebehol posledný tick (net_clock_us)
+    int playerCount;
+    int gameRunning;
+    int foodCount;
+    position_t food[ENGINE_MAX_FOOD];
+
+    int playerId[ENGINE_LANES];
+    direction_t direction[ENGINE_LANES];
+    int score[ENGINE_LANES];
+
+    // Studené polia
+    uint8_t cells[ARENA_MAX_WIDTH * ARENA_MAX_HEIGHT];  // cells[y * width + x]
+    uint64_t claimBits[ARENA_MAX_WIDTH * ARENA_MAX_HEIGHT / 64];  // Nové hlavy v ticku variantov *_SMALL, inak nulové
+    position_t body[ENGINE_LANES][MAX_SNAKE_LENGTH];
+} game_engine_t;
+
+// Inicializuje stav hry na prazdno (klasická aréna)
+void game_init(game_engine_t *state);
+
+// Nastaví rozmery arény a kapacitu hadíkov prázdnej hry, vráti 0 alebo -1
+int game_configure(game_engine_t *state, int width, int height, int maxSnakes);
 
 // Resetuje hru po skončení (vyčisti player_count a resources)
-void game_reset(game_state_t *state);
+void game_reset(game_engine_t *state);
 
 // Prida hraca, vrati index noveho hraca alebo -1 ak je plno
-int game_add_player(game_state_t *state, int playerId);
+int game_add_player(game_engine_t *state, int playerId);
 
 // Označí hráča ako neaktívneho (mŕtvy/odpojený)
 // permanent=1: resetuje slot úplne (aby sa mohol pripojiť ďalší)
 // permanent=0: iba označí ako mŕtveho (hráč sa môže vrátiť)
-void game_remove_player(game_state_t *state, int playerIdx, int permanent);
+void game_remove_player(game_engine_t *state, int playerIdx, int permanent);
 
 // Spracuje vstup klienta (smer/pauza/quit) podľa player_id
-void game_process_input(game_state_t *state, int playerId, const client_input_t *input);
+void game_process_input(game_engine_t *state, int playerId, const client_input_t *input);
+
+// Jeden tick hernej logiky v dvoch fázach, výsledok nezávisí od poradia slotov:
+// 1. výpočet nových hláv a kolízií voči mriežke pred tickom (pri veľa hadíkoch paralelne),
+// 2. hadíky s rovnakou novou hlavou zomrú všetky, ostatní zjedia ovocie a posunú sa.
+void game_tick(game_engine_t *state);
+
+// Vynúti variant ticku (benchmark); vráti -1, ak variant rozmerom nezodpovedá
+int game_set_tick_kernel(game_engine_t *state, tick_kernel_t kernel);
+
+// Názov variantu ticku
+const char *game_tick_kernel_name(tick_kernel_t kernel);
+
+// Počet vlákien pre fázu 1 veľkých arén (0 alebo 1 = všetko vo volajúcom vlákne)
+void game_set_tick_threads(int threads);
+
+// 1 ak hráč na indexe žije
+int game_player_alive(const game_engine_t *state, int playerIdx);
+
+// 1 ak má hráč na indexe pauzu
+int game_player_paused(const game_engine_t *state, int playerIdx);
+
+// k-ty článok tela hadíka (0 = hlava)
+position_t game_snake_cell(const game_engine_t *state, int playerIdx, int k);
+
+// Počet obsadených slotov
+int game_used_slots(const game_engine_t *state);
+
+// Skopíruje stav bez mriežky obsadenosti a nepoužitých slotov (checkpoint)
+void game_copy(game_engine_t *dst, const game_engine_t *src);
 
-// Jeden tick hernej logiky (pohyb, kolízie, ovocie, skóre)
-void game_tick(game_state_t *state);
+// Dopočíta mriežku obsadenosti z tiel a ovocia (po game_copy)
+void game_rebuild_cells(game_engine_t *state);
 
 #endif // GAME_H
@@ -0,0 +1,220 @@
+#include "game_ref.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const int refStepX[] = {0, 0, -1, 1, 0};
+static const int refStepY[] = {-1, 1, 0, 0, 0};
+
+static int ref_body_at(const ref_game_t *game, int x, int y) {
+    for (int i = 0; i < game->maxSnakes; i++) {
+        const ref_snake_t *s = &game->snakes[i];
+        if (!s->alive) continue;
+        for (int k = 0; k < s->length; k++) {
+            if (s->body[k].x == x && s->body[k].y == y) return 1;
+        }
+    }
+    return 0;
+}
+
+static int ref_food_index(const ref_game_t *game, int x, int y) {
+    for (int f = 0; f < game->foodCount; f++) {
+        if (game->food[f].x == x && game->food[f].y == y) return f;
+    }
+    return -1;
+}
+
+static int ref_occupied(const ref_game_t *game, int x, int y) {
+    return ref_body_at(game, x, y) || ref_food_index(game, x, y) >= 0;
+}
+
+static int ref_alive_count(const ref_game_t *game) {
+    int alive = 0;
+    for (int i = 0; i < game->maxSnakes; i++) alive += game->snakes[i].alive;
+    return alive;
+}
+
+// Náhodné voľné políčko: najprv 4*plocha pokusov, potom prvé voľné po riadkoch
+static int ref_free_position(const ref_game_t *game, position_t *out) {
+    int area = game->width * game->height;
+    for (int attempt = 0; attempt < 4 * area; attempt++) {
+        int x = rand() % game->width;
+        int y = rand() % game->height;
+        if (!ref_occupied(game, x, y)) {
+            out->x = x;
+            out->y = y;
+            return 0;
+        }
+    }
+    for (int c = 0; c < area; c++) {
+        if (!ref_occupied(game, c % game->width, c / game->width)) {
+            out->x = c % game->width;
+            out->y = c / game->width;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static void ref_spawn_food(ref_game_t *game) {
+    int target = ref_alive_count(game);
+    if (target < 1) target = 1;
+    while (game->foodCount < target && game->foodCount < ENGINE_MAX_FOOD) {
+        position_t p;
+        if (ref_free_position(game, &p) < 0) break;
+        game->food[game->foodCount++] = p;
+    }
+}
+
+static int ref_opposite(direction_t a, direction_t b) {
+    return (a == DIR_UP && b == DIR_DOWN) || (a == DIR_DOWN && b == DIR_UP) ||
+           (a == DIR_LEFT && b == DIR_RIGHT) || (a == DIR_RIGHT && b == DIR_LEFT);
+}
+
+void ref_init(ref_game_t *game, int width, int height, int maxSnakes) {
+    memset(game, 0, sizeof(*game));
+    game->width = width;
+    game->height = height;
+    game->maxSnakes = maxSnakes;
+    for (int i = 0; i < ENGINE_LANES; i++) {
+        game->snakes[i].playerId = -1;
+    }
+}
+
+int ref_add_player(ref_game_t *game, int playerId) {
+    for (int i = 0; i < game->maxSnakes; i++) {
+        if (game->snakes[i].playerId == playerId && game->snakes[i].alive) return i;
+    }
+    for (int i = 0; i < game->maxSnakes; i++) {
+        if (game->snakes[i].playerId == playerId && !game->snakes[i].alive) return -2;
+    }
+
+    int idx = -1;
+    for (int i = 0; i < game->maxSnakes; i++) {
+        if (!game->snakes[i].used) {
+            idx = i;
+            break;
+        }
+    }
+    position_t head;
+    if (idx == -1 || ref_free_position(game, &head) < 0) return -1;
+
+    ref_snake_t *s = &game->snakes[idx];
+    s->used = 1;
+    s->playerId = playerId;
+    s->alive = 1;
+    s->paused = 0;
+    s->direction = DIR_RIGHT;
+    s->score = 0;
+    s->length = 3;
+    s->body[0] = head;
+    s->body[1] = (position_t){(head.x - 1 + game->width) % game->width, head.y};
+    s->body[2] = (position_t){(head.x - 2 + game->width) % game->width, head.y};
+
+    game->playerCount++;
+    game->gameRunning = 1;
+    ref_spawn_food(game);
+    return idx;
+}
+
+void ref_remove_player(ref_game_t *game, int playerIdx, int permanent) {
+    if (playerIdx < 0 || playerIdx >= game->maxSnakes) return;
+    ref_snake_t *s = &game->snakes[playerIdx];
+    if (!s->used) return;
+
+    if (s->alive && game->playerCount > 0) game->playerCount--;
+    s->alive = 0;
+    s->paused = 0;
+    if (permanent) {
+        s->used = 0;
+        s->playerId = -1;
+        s->length = 0;
+        s->score = 0;
+        s->direction = DIR_UP;
+    }
+}
+
+void ref_process_input(ref_game_t *game, int playerId, const client_input_t *input) {
+    if (!input) return;
+    int idx = -1;
+    for (int i = 0; i < game->maxSnakes; i++) {
+        if (game->snakes[i].playerId == playerId) {
+            idx = i;
+            break;
+        }
+    }
+    if (idx < 0 || !game->snakes[idx].alive) return;
+
+    ref_snake_t *s = &game->snakes[idx];
+    switch (input->action) {
+        case ACTION_MOVE:
+            if ((unsigned)input->direction <= DIR_NONE && !ref_opposite(s->direction, input->direction)) {
+                s->direction = input->direction;
+            }
+            s->paused = 0;
+            break;
+        case ACTION_QUIT:
+            s->alive = 0;
+            break;
+        case ACTION_PAUSE:
+            s->paused = !s->paused;
+            break;
+        default:
+            break;
+    }
+}
+
+void ref_tick(ref_game_t *game) {
+    static int nextX[ENGINE_LANES], nextY[ENGINE_LANES];
+    static int moving[ENGINE_LANES], dies[ENGINE_LANES];
+
+    // Všetky rozhodnutia vychádzajú zo stavu pred tickom
+    for (int i = 0; i < game->maxSnakes; i++) {
+        ref_snake_t *s = &game->snakes[i];
+        moving[i] = s->alive && !s->paused;
+        dies[i] = 0;
+        if (!moving[i]) continue;
+        int x = s->body[0].x + refStepX[s->direction];
+        int y = s->body[0].y + refStepY[s->direction];
+        nextX[i] = (x + game->width) % game->width;
+        nextY[i] = (y + game->height) % game->height;
+        dies[i] = ref_body_at(game, nextX[i], nextY[i]);
+    }
+
+    // Neblokovaní hadíci s rovnakou novou hlavou zomrú všetci
+    for (int i = 0; i < game->maxSnakes; i++) {
+        if (!moving[i] || ref_body_at(game, nextX[i], nextY[i])) continue;
+        for (int j = 0; j < game->maxSnakes; j++) {
+            if (j != i && moving[j] && nextX[j] == nextX[i] && nextY[j] == nextY[i] &&
+                !ref_body_at(game, nextX[j], nextY[j])) {
+                dies[i] = 1;
+            }
+        }
+    }
+
+    for (int i = 0; i < game->maxSnakes; i++) {
+        if (moving[i] && dies[i]) game->snakes[i].alive = 0;
+    }
+
+    for (int i = 0; i < game->maxSnakes; i++) {
+        if (!moving[i] || dies[i]) continue;
+        ref_snake_t *s = &game->snakes[i];
+        int ate = 0;
+        int f = ref_food_index(game, nextX[i], nextY[i]);
+        if (f >= 0) {
+            ate = 1;
+            s->score += 10;
+            game->food[f] = game->food[game->foodCount - 1];
+            game->foodCount--;
+        }
+        int grow = ate && s->length < MAX_SNAKE_LENGTH;
+        int keep = grow ? s->length : s->length - 1;
+        memmove(&s->body[1], &s->body[0], (size_t)keep * sizeof(position_t));
+        s->body[0] = (position_t){nextX[i], nextY[i]};
+        if (grow) s->length++;
+    }
+
+    ref_spawn_food(game);
+    int alive = ref_alive_count(game);
+    game->playerCount = alive;
+    game->gameRunning = alive > 0;
+}
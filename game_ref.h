@@ -0,0 +1,44 @@
+#ifndef GAME_REF_H
+#define GAME_REF_H
+
+#include "shared.h"
+#include "game.h"
+
+// Zmrazená referenčná implementácia pravidiel hry pre diferenciálny fuzz.
+// Zámerne jednoduchá (pole štruktúr, telá s hlavou na indexe 0, obsadenosť
+// sa hľadá prechodom tiel) a pri optimalizáciách game.c sa NEMENÍ.
+// Zhoduje sa s game.c aj v poradí volaní rand(), takže po rovnakom srand()
+// musia oba enginy skončiť v rovnakom stave.
+
+typedef struct RefSnake {
+    int used;
+    int playerId;            // -1 = voľný slot
+    int alive;
+    int paused;
+    direction_t direction;
+    int length;
+    int score;
+    position_t body[MAX_SNAKE_LENGTH];  // body[0] = hlava
+} ref_snake_t;
+
+typedef struct RefGame {
+    int width;
+    int height;
+    int maxSnakes;
+    int playerCount;
+    int gameRunning;
+    int foodCount;
+    position_t food[ENGINE_MAX_FOOD];
+    ref_snake_t snakes[ENGINE_LANES];
+} ref_game_t;
+
+// Prázdna hra s danými rozmermi (ako game_init + game_configure)
+void ref_init(ref_game_t *game, int width, int height, int maxSnakes);
+
+// Rovnaká sémantika ako game_add_player / game_remove_player / game_process_input / game_tick
+int ref_add_player(ref_game_t *game, int playerId);
+void ref_remove_player(ref_game_t *game, int playerIdx, int permanent);
+void ref_process_input(ref_game_t *game, int playerId, const client_input_t *input);
+void ref_tick(ref_game_t *game);
+
+#endif // GAME_REF_H
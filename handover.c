@@ -0,0 +1,71 @@
+#include "handover.h"
+#include "net.h"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static int fill_address(struct sockaddr_un *addr, const char *path) {
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr->sun_path)) return -1;
+    strcpy(addr->sun_path, path);
+    return 0;
+}
+
+int handover_listen(const char *path) {
+    struct sockaddr_un addr;
+    if (fill_address(&addr, path) < 0) return -1;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+
+    unlink(path);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, 1) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int handover_send(int ctlFd, int listenerFd, const int *clientFds, const handover_info_t *info) {
+    int fds[MAX_PLAYERS + 1];
+    fds[0] = listenerFd;
+    for (int i = 0; i < info->clientCount; i++) {
+        fds[i + 1] = clientFds[i];
+    }
+    if (net_send_fds(ctlFd, fds, info->clientCount + 1, info, sizeof(*info)) < 0) return -1;
+
+    // Počkaj, kým nový proces potvrdí prevzatie
+    char ack;
+    return recv(ctlFd, &ack, 1, 0) == 1 ? 0 : -1;
+}
+
+int handover_request(const char *path, int *listenerFd, int *clientFds, handover_info_t *info) {
+    struct sockaddr_un addr;
+    if (fill_address(&addr, path) < 0) return -1;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+
+    int fds[MAX_PLAYERS + 1];
+    int count = net_recv_fds(fd, fds, MAX_PLAYERS + 1, info, sizeof(*info));
+    if (count < 1 || info->clientCount != count - 1) {
+        for (int i = 0; i < count; i++) close(fds[i]);
+        close(fd);
+        return -1;
+    }
+
+    *listenerFd = fds[0];
+    for (int i = 0; i < info->clientCount; i++) {
+        clientFds[i] = fds[i + 1];
+    }
+
+    char ack = 1;
+    send(fd, &ack, 1, MSG_NOSIGNAL);
+    close(fd);
+    return 0;
+}
@@ -0,0 +1,31 @@
+#ifndef HANDOVER_H
+#define HANDOVER_H
+
+#include "shared.h"
+
+// Odovzdanie počúvajúceho socketu a klientskych spojení novej binárke
+// cez Unix socket (SCM_RIGHTS). Stav hier sa prenáša cez snapshot.
+
+// Metadáta klienta, ktorého deskriptor sa odovzdáva
+typedef struct HandoverClient {
+    int playerId;
+    int playerIdx;
+    int gameId;
+} handover_client_t;
+
+typedef struct HandoverInfo {
+    int clientCount;
+    handover_client_t clients[MAX_PLAYERS];
+} handover_info_t;
+
+// Otvorí riadiaci socket na path (starý súbor prepíše), vráti deskriptor alebo -1
+int handover_listen(const char *path);
+
+// Starý proces: pošle listener a klientov spojeniu ctlFd, vráti 0 alebo -1
+int handover_send(int ctlFd, int listenerFd, const int *clientFds, const handover_info_t *info);
+
+// Nový proces: pripojí sa k bežiacemu serveru a prevezme jeho deskriptory.
+// Vráti 0 alebo -1; clientFds musí mať miesto pre MAX_PLAYERS deskriptorov.
+int handover_request(const char *path, int *listenerFd, int *clientFds, handover_info_t *info);
+
+#endif // HANDOVER_H
@@ -0,0 +1,102 @@
+#include "lobby.h"
+#include <stdatomic.h>
+#include <string.h>
+#include <sys/mman.h>
+
+typedef struct LobbySlot {
+    atomic_uint seq;         // Nepárne = práve sa zapisuje
+    int listed;              // 1 ak hra beží a má byť v zozname
+    game_summary_t summary;
+} lobby_slot_t;
+
+typedef struct LobbyShared {
+    atomic_uint generation;
+    lobby_slot_t slots[MAX_PLAYERS];
+} lobby_shared_t;
+
+static lobby_shared_t *shared;
+
+// Čitateľ po toľkých nepárnych/nekonzistentných čítaniach slot preskočí
+// (shard mohol spadnúť uprostred zápisu, slot opraví až lobby_reset)
+#define LOBBY_READ_RETRIES 1000
+
+int lobby_init(void) {
+    void *mem = mmap(NULL, sizeof(lobby_shared_t), PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) return -1;
+    shared = mem; // mmap vracia vynulovanú pamäť
+    return 0;
+}
+
+void lobby_summarize(const game_engine_t *state, game_summary_t *out) {
+    memset(out, 0, sizeof(*out));
+    out->gameId = state->gameId;
+    out->playerCount = state->playerCount;
+    out->elapsedTime = state->elapsedTime;
+    out->freeSlots = state->maxSnakes - game_used_slots(state);
+    for (int i = 0; i < state->maxSnakes; i++) {
+        if (state->score[i] > out->topScore) out->topScore = state->score[i];
+    }
+}
+
+static void write_slot(int gameId, int listed, const game_summary_t *summary) {
+    lobby_slot_t *slot = &shared->slots[gameId];
+    unsigned seq = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+    seq += seq & 1u; // Zapisovateľ mohol spadnúť uprostred zápisu
+
+    atomic_store_explicit(&slot->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    slot->listed = listed;
+    if (summary) slot->summary = *summary;
+    atomic_store_explicit(&slot->seq, seq + 2, memory_order_release);
+
+    atomic_fetch_add_explicit(&shared->generation, 1, memory_order_release);
+}
+
+void lobby_publish(int gameId, const game_summary_t *summary) {
+    if (gameId < 0 || gameId >= MAX_PLAYERS) return;
+    lobby_slot_t *slot = &shared->slots[gameId];
+    // Jediný zapisovateľ slotu je herné vlákno, takže čítanie bez seqlocku je bezpečné
+    if (slot->listed && memcmp(&slot->summary, summary, sizeof(*summary)) == 0) return;
+    write_slot(gameId, 1, summary);
+}
+
+void lobby_clear(int gameId) {
+    if (gameId < 0 || gameId >= MAX_PLAYERS) return;
+    if (!shared->slots[gameId].listed) return;
+    write_slot(gameId, 0, NULL);
+}
+
+void lobby_reset(int gameId) {
+    if (gameId < 0 || gameId >= MAX_PLAYERS) return;
+    write_slot(gameId, 0, NULL);
+}
+
+unsigned lobby_generation(void) {
+    return atomic_load_explicit(&shared->generation, memory_order_acquire);
+}
+
+void lobby_snapshot(game_list_t *out) {
+    out->count = 0;
+    for (int i = 0; i < MAX_PLAYERS; i++) {
+        lobby_slot_t *slot = &shared->slots[i];
+        game_summary_t copy;
+        int listed = 0;
+        unsigned before, after;
+        int tries = 0;
+        do {
+            if (++tries > LOBBY_READ_RETRIES) {
+                listed = 0;
+                break;
+            }
+            before = atomic_load_explicit(&slot->seq, memory_order_acquire);
+            if (before & 1u) continue;
+            listed = slot->listed;
+            copy = slot->summary;
+            atomic_thread_fence(memory_order_acquire);
+            after = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+        } while ((before & 1u) || before != after);
+
+        if (listed) out->games[out->count++] = copy;
+    }
+}
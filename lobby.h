@@ -0,0 +1,31 @@
+#ifndef LOBBY_H
+#define LOBBY_H
+
+#include "shared.h"
+#include "game.h"
+
+// Lobby drží súhrny bežiacich hier v seqlock slotoch.
+// Zapisuje iba herné vlákno danej hry, čitatelia nikdy neberú herné mutexy.
+
+// Alokuje sloty v zdieľanej pamäti (volať pred fork, aby lobby videli všetky shardy)
+int lobby_init(void);
+
+// Vypočíta súhrn zo stavu hry (volať pod zámkom hry)
+void lobby_summarize(const game_engine_t *state, game_summary_t *out);
+
+// Publikuje súhrn hry po ticku; nezmenený súhrn sa nezapisuje
+void lobby_publish(int gameId, const game_summary_t *summary);
+
+// Odstráni hru zo zoznamu (hra skončila)
+void lobby_clear(int gameId);
+
+// Vynúti uvoľnenie slotu aj po páde zapisovateľa (volá supervisor)
+void lobby_reset(int gameId);
+
+// Generácia sa zvýši pri každej zmene, podľa nej sa dá cachovať odpoveď
+unsigned lobby_generation(void);
+
+// Naplní zoznam bežiacich hier z konzistentných snapshotov slotov
+void lobby_snapshot(game_list_t *out);
+
+#endif // LOBBY_H
@@ -0,0 +1,185 @@
+#include "net.h"
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+int net_send_msg(int fd, int type, const void *payload, int length) {
+    msg_header_t hdr;
+    hdr.type = type;
+    hdr.length = length;
+
+    struct iovec iov[2];
+    iov[0].iov_base = &hdr;
+    iov[0].iov_len = sizeof(hdr);
+    iov[1].iov_base = (void *)payload;
+    iov[1].iov_len = (size_t)length;
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = 2;
+
+    size_t total = sizeof(hdr) + (size_t)length;
+    size_t sent = 0;
+    while (sent < total) {
+        ssize_t n = sendmsg(fd, &msg, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        sent += (size_t)n;
+        // Posuň iovec za už odoslané bajty
+        while (n > 0 && msg.msg_iovlen > 0) {
+            if ((size_t)n >= msg.msg_iov[0].iov_len) {
+                n -= (ssize_t)msg.msg_iov[0].iov_len;
+                msg.msg_iov++;
+                msg.msg_iovlen--;
+            } else {
+                msg.msg_iov[0].iov_base = (char *)msg.msg_iov[0].iov_base + n;
+                msg.msg_iov[0].iov_len -= (size_t)n;
+                n = 0;
+            }
+        }
+    }
+    return 0;
+}
+
+int net_put_header(void *buf, int type, int length) {
+    msg_header_t hdr;
+    hdr.type = type;
+    hdr.length = length;
+    memcpy(buf, &hdr, sizeof(hdr));
+    return (int)sizeof(hdr) + length;
+}
+
+int net_send_all(int fd, const void *buf, int length) {
+    const char *p = buf;
+    while (length > 0) {
+        ssize_t n = send(fd, p, (size_t)length, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += n;
+        length -= (int)n;
+    }
+    return 0;
+}
+
+void net_reader_init(msg_reader_t *reader) {
+    reader->used = 0;
+}
+
+// Vyberie kompletnú správu z buffera, ak tam je
+static int pop_message(msg_reader_t *reader, msg_header_t *hdr, void *payload, int maxLen) {
+    if (reader->used < (int)sizeof(msg_header_t)) return 0;
+
+    msg_header_t h;
+    memcpy(&h, reader->buf, sizeof(h));
+    if (h.length < 0 || h.length > NET_RX_BUFFER - (int)sizeof(msg_header_t)) {
+        return -1; // Poškodený stream
+    }
+
+    int total = (int)sizeof(msg_header_t) + h.length;
+    if (reader->used < total) return 0;
+
+    *hdr = h;
+    int copy = h.length < maxLen ? h.length : maxLen;
+    memcpy(payload, reader->buf + sizeof(msg_header_t), (size_t)copy);
+    if (copy < h.length) hdr->length = copy;
+
+    reader->used -= total;
+    memmove(reader->buf, reader->buf + total, (size_t)reader->used);
+    return 1;
+}
+
+int net_recv_msg(int fd, msg_reader_t *reader, msg_header_t *hdr, void *payload, int maxLen) {
+    int ret = pop_message(reader, hdr, payload, maxLen);
+    if (ret != 0) return ret;
+
+    ssize_t n = recv(fd, reader->buf + reader->used, (size_t)(NET_RX_BUFFER - reader->used), 0);
+    if (n == 0) return -1;
+    if (n < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) return 0;
+        return -1;
+    }
+    reader->used += (int)n;
+    return pop_message(reader, hdr, payload, maxLen);
+}
+
+int net_send_fds(int sock, const int *fds, int count, const void *data, int length) {
+    if (count < 0 || count > NET_MAX_FDS) return -1;
+
+    struct iovec iov;
+    iov.iov_base = (void *)data;
+    iov.iov_len = (size_t)length;
+
+    char control[CMSG_SPACE(sizeof(int) * NET_MAX_FDS)];
+    memset(control, 0, sizeof(control));
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    if (count > 0) {
+        msg.msg_control = control;
+        msg.msg_controllen = CMSG_SPACE(sizeof(int) * (size_t)count);
+        struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int) * (size_t)count);
+        memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * (size_t)count);
+    }
+
+    ssize_t n;
+    do {
+        n = sendmsg(sock, &msg, MSG_NOSIGNAL);
+    } while (n < 0 && errno == EINTR);
+    return n == length ? 0 : -1;
+}
+
+int net_recv_fds(int sock, int *fds, int maxCount, void *data, int length) {
+    struct iovec iov;
+    iov.iov_base = data;
+    iov.iov_len = (size_t)length;
+
+    char control[CMSG_SPACE(sizeof(int) * NET_MAX_FDS)];
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    ssize_t n;
+    do {
+        n = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0) return -1;
+    // Pri krátkej alebo orezanej správe sa zavrú aj deskriptory, ktoré už prišli
+    int failed = n != length || (msg.msg_flags & MSG_CTRUNC);
+
+    int count = 0;
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) continue;
+        int received = (int)((cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int));
+        int *src = (int *)CMSG_DATA(cmsg);
+        for (int i = 0; i < received; i++) {
+            if (!failed && count < maxCount) {
+                fds[count++] = src[i];
+            } else {
+                close(src[i]); // Nečakaný deskriptor navyše
+            }
+        }
+    }
+    return failed ? -1 : count;
+}
+
+uint32_t net_clock_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u);
+}
@@ -0,0 +1,43 @@
+#ifndef NET_H
+#define NET_H
+
+#include "shared.h"
+
+// Kapacita prijímacieho buffera (aspoň dve najväčšie správy)
+#define NET_RX_BUFFER (2 * ((int)sizeof(msg_header_t) + VIEW_MAX_BYTES))
+
+// Skladá správy z TCP streamu (recv môže vrátiť aj časť správy)
+typedef struct MsgReader {
+    char buf[NET_RX_BUFFER];
+    int used;
+} msg_reader_t;
+
+// Pošle celú správu (hlavička + payload) jedným volaním, vráti 0 alebo -1
+int net_send_msg(int fd, int type, const void *payload, int length);
+
+// Zapíše hlavičku správy na začiatok buf (payload nasleduje hneď za ňou),
+// vráti celkovú dĺžku správy
+int net_put_header(void *buf, int type, int length);
+
+// Pošle celý buffer (dokončí krátke sendy), vráti 0 alebo -1
+int net_send_all(int fd, const void *buf, int length);
+
+void net_reader_init(msg_reader_t *reader);
+
+// Monotónne hodiny v µs pre pečiatky (pretečú, porovnávať iba rozdielom)
+uint32_t net_clock_us(void);
+
+// Vráti 1 ak je v hdr/payload kompletná správa, 0 ak treba viac dát (EAGAIN),
+// -1 pri chybe alebo zatvorenom spojení. Payload dlhší ako maxLen sa oreže.
+int net_recv_msg(int fd, msg_reader_t *reader, msg_header_t *hdr, void *payload, int maxLen);
+
+// Maximálny počet deskriptorov v jednej SCM_RIGHTS správe
+#define NET_MAX_FDS 32
+
+// Pošle deskriptory cez Unix socket (SCM_RIGHTS) spolu s dátami, vráti 0 alebo -1
+int net_send_fds(int sock, const int *fds, int count, const void *data, int length);
+
+// Prijme dáta a deskriptory, vráti počet prijatých deskriptorov alebo -1
+int net_recv_fds(int sock, int *fds, int maxCount, void *data, int length);
+
+#endif // NET_H
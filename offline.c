@@ -0,0 +1,179 @@
+#include "transport.h"
+#include "aoi.h"
+#include "game.h"
+#include "lobby.h"
+#include "net.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Offline hra: engine beží priamo v klientovi, tick sa posúva podľa hodín pri
+// každom recv_msg. Správy vyzerajú rovnako ako zo servera (MSG_VIEW/MSG_GAME_LIST),
+// takže klient nad nimi používa ten istý kód ako v sieťovej hre.
+
+#define OFFLINE_GAME_ID 0
+
+typedef struct OfflineTransport {
+    game_engine_t *game;
+    int active;              // Hra beží
+    int playerIdx;           // Slot hráča, -1 ak v hre nie je (výrezy sa neposielajú)
+    int elapsedMs;
+    int tickMs;              // Dĺžka ticku, 0 = jeden tick pri každom recv_msg (benchmark)
+    long long nextTickMs;
+    aoi_index_t index;
+    aoi_subscription_t sub;
+    int listPending;
+    game_list_t list;
+    int boardPending;        // Offline hry sa do rebríčka nezapisujú, odpoveď je prázdna
+    int viewPending;         // Najnovší nevyzdvihnutý výrez (starší sa prepíše)
+    int viewLength;
+    char view[VIEW_MAX_BYTES];
+} offline_transport_t;
+
+static long long now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+// Zakóduje výrez hráča, ako by ho poslal broadcast_views
+static void queue_view(offline_transport_t *off) {
+    aoi_build_index(&off->index, off->game);
+    off->viewLength = aoi_encode_view(&off->index, off->game, off->playerIdx, &off->sub,
+                                      off->view, VIEW_MAX_BYTES);
+    off->viewPending = 1;
+}
+
+// Dobehne tiky, ktoré už mali prebehnúť
+static void advance(offline_transport_t *off) {
+    long long now = now_ms();
+    int ticked = 0;
+    while (off->active && now >= off->nextTickMs && (off->tickMs > 0 || !ticked)) {
+        game_tick(off->game);
+        off->game->tickStampUs = net_clock_us();
+        off->elapsedMs += GAME_LOOP_MS;
+        off->game->elapsedTime = off->elapsedMs / 1000;
+        off->nextTickMs += off->tickMs;
+        ticked = 1;
+        if (!off->game->gameRunning) off->active = 0;
+    }
+    if (ticked && off->playerIdx >= 0) {
+        queue_view(off);
+        if (!off->active) off->playerIdx = -1; // Skončená hra hráča uvoľní
+    }
+}
+
+static void start_game(offline_transport_t *off, int playerId) {
+    game_init(off->game);
+    game_configure(off->game, WORLD_WIDTH, WORLD_HEIGHT, MAX_PLAYERS);
+    off->game->gameId = OFFLINE_GAME_ID;
+    off->game->tickStampUs = net_clock_us();
+    off->playerIdx = game_add_player(off->game, playerId);
+    off->elapsedMs = 0;
+    off->active = 1;
+    off->nextTickMs = now_ms() + off->tickMs;
+    aoi_reset(&off->sub);
+    queue_view(off);
+}
+
+static int offline_send_input(transport_t *t, const client_input_t *input) {
+    offline_transport_t *off = t->ctx;
+    advance(off);
+    int inGame = off->playerIdx >= 0;
+
+    if (input->action == ACTION_LIST_GAMES) {
+        memset(&off->list, 0, sizeof(off->list));
+        if (off->active) {
+            lobby_summarize(off->game, &off->list.games[0]);
+            off->list.count = 1;
+        }
+        off->listPending = 1;
+    } else if (input->action == ACTION_LEADERBOARD) {
+        off->boardPending = 1;
+    } else if (inGame && input->action == ACTION_QUIT) {
+        game_remove_player(off->game, off->playerIdx, 1);
+        off->playerIdx = -1;
+        off->viewPending = 0;
+    } else if (!inGame && (input->action == ACTION_CREATE_GAME ||
+                           (input->action == ACTION_QUICK_JOIN && !off->active))) {
+        start_game(off, input->playerId); // Jediná lokálna hra, stará sa zahodí
+    } else if (!inGame && (input->action == ACTION_JOIN_GAME || input->action == ACTION_QUICK_JOIN)) {
+        if (off->active && (input->action == ACTION_QUICK_JOIN || input->gameId == OFFLINE_GAME_ID)) {
+            off->playerIdx = game_add_player(off->game, input->playerId);
+            aoi_reset(&off->sub);
+            queue_view(off);
+        }
+    } else if (inGame) {
+        game_process_input(off->game, input->playerId, input);
+    }
+    return 0;
+}
+
+static int offline_recv_msg(transport_t *t, msg_header_t *hdr, void *payload, int maxLen) {
+    offline_transport_t *off = t->ctx;
+    advance(off);
+
+    if (off->listPending) {
+        off->listPending = 0;
+        hdr->type = MSG_GAME_LIST;
+        hdr->length = (int)(offsetof(game_list_t, games) + (size_t)off->list.count * sizeof(game_summary_t));
+        memcpy(payload, &off->list, (size_t)(hdr->length < maxLen ? hdr->length : maxLen));
+        return 1;
+    }
+    if (off->boardPending) {
+        off->boardPending = 0;
+        hdr->type = MSG_LEADERBOARD;
+        hdr->length = (int)offsetof(leaderboard_t, top);
+        memset(payload, 0, (size_t)(hdr->length < maxLen ? hdr->length : maxLen));
+        return 1;
+    }
+    if (off->viewPending) {
+        off->viewPending = 0;
+        hdr->type = MSG_VIEW;
+        hdr->length = off->viewLength;
+        memcpy(payload, off->view, (size_t)(off->viewLength < maxLen ? off->viewLength : maxLen));
+        return 1;
+    }
+    return 0;
+}
+
+static int offline_poll_fd(transport_t *t) {
+    (void)t;
+    return -1;
+}
+
+static int offline_wait_ms(transport_t *t) {
+    offline_transport_t *off = t->ctx;
+    if (off->listPending || off->boardPending || off->viewPending) return 0;
+    if (!off->active) return -1;
+    long long left = off->nextTickMs - now_ms();
+    return left > 0 ? (int)left : 0;
+}
+
+static void offline_close(transport_t *t) {
+    offline_transport_t *off = t->ctx;
+    free(off->game);
+    free(off);
+    t->ctx = NULL;
+}
+
+int transport_open_offline(transport_t *t, int tickMs) {
+    offline_transport_t *off = calloc(1, sizeof(*off));
+    if (!off) return -1;
+    off->game = malloc(sizeof(game_engine_t));
+    if (!off->game) {
+        free(off);
+        return -1;
+    }
+    off->playerIdx = -1;
+    off->tickMs = tickMs;
+
+    t->send_input = offline_send_input;
+    t->recv_msg = offline_recv_msg;
+    t->poll_fd = offline_poll_fd;
+    t->wait_ms = offline_wait_ms;
+    t->close = offline_close;
+    t->ctx = off;
+    return 0;
+}
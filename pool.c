@@ -0,0 +1,41 @@
+#include "pool.h"
+#include <sys/mman.h>
+
+#define POOL_ALIGN 64
+
+static size_t total_size(const pool_t *pool) {
+    return pool->objSize * (size_t)pool->capacity + sizeof(int) * (size_t)pool->capacity;
+}
+
+int pool_init(pool_t *pool, size_t objSize, int capacity) {
+    pool->base = NULL;
+    if (capacity <= 0 || objSize == 0) return -1;
+    pool->objSize = (objSize + POOL_ALIGN - 1) & ~(size_t)(POOL_ALIGN - 1);
+    pool->capacity = capacity;
+    pool->created = 0;
+    pool->freeCount = 0;
+
+    // MAP_NORESERVE: nepoužité objekty nezaberajú pamäť ani swap
+    void *mem = mmap(NULL, total_size(pool), PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (mem == MAP_FAILED) return -1;
+    pool->base = mem;
+    pool->freeList = (int *)(pool->base + pool->objSize * (size_t)capacity);
+    return 0;
+}
+
+void *pool_alloc(pool_t *pool) {
+    if (pool->freeCount > 0) {
+        int idx = pool->freeList[--pool->freeCount];
+        return pool->base + pool->objSize * (size_t)idx;
+    }
+    if (pool->created >= pool->capacity) return NULL;
+    // Nový objekt leží na ešte nedotknutých (nulových) stránkach
+    return pool->base + pool->objSize * (size_t)pool->created++;
+}
+
+void pool_free(pool_t *pool, void *obj) {
+    if (!obj) return;
+    size_t offset = (size_t)((char *)obj - pool->base);
+    pool->freeList[pool->freeCount++] = (int)(offset / pool->objSize);
+}
@@ -0,0 +1,29 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <stddef.h>
+
+// Slab rovnako veľkých objektov v jednej mmap oblasti s LIFO zoznamom voľných.
+// Stránky fyzicky vzniknú až pri prvom použití objektu a uvoľnený objekt sa
+// vráti ako prvý, takže opakované create/join používa už teplú pamäť bez malloc.
+// Pool nezamyká, volajúci ho chráni svojím zámkom.
+
+typedef struct Pool {
+    char *base;
+    size_t objSize;     // Zaokrúhlené na cache line
+    int capacity;
+    int created;        // Objekty [0, created) už boli aspoň raz vydané
+    int freeCount;
+    int *freeList;      // Indexy vrátených objektov (zásobník)
+} pool_t;
+
+// Rezervuje miesto pre capacity objektov, vráti 0 alebo -1
+int pool_init(pool_t *pool, size_t objSize, int capacity);
+
+// Vráti objekt (pri prvom vydaní vynulovaný) alebo NULL ak je pool plný
+void *pool_alloc(pool_t *pool);
+
+// Vráti objekt do poolu, obsah zostáva (volajúci ho pri ďalšom vydaní prepíše)
+void pool_free(pool_t *pool, void *obj);
+
+#endif // POOL_H
@@ -0,0 +1,29 @@
+#include "ratelimit.h"
+#include <time.h>
+
+int64_t ratelimit_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+void bucket_init(token_bucket_t *bucket, int ratePerSec, int burst, int64_t nowMs) {
+    bucket->ratePerSec = ratePerSec;
+    bucket->burst = burst;
+    bucket->milliTokens = (int64_t)burst * 1000;
+    bucket->lastMs = nowMs;
+}
+
+int bucket_take(token_bucket_t *bucket, int64_t nowMs) {
+    int64_t elapsed = nowMs - bucket->lastMs;
+    if (elapsed > 0) {
+        // Za 1 ms pribudne ratePerSec tisícin tokenu
+        bucket->milliTokens += elapsed * bucket->ratePerSec;
+        int64_t cap = (int64_t)bucket->burst * 1000;
+        if (bucket->milliTokens > cap) bucket->milliTokens = cap;
+        bucket->lastMs = nowMs;
+    }
+    if (bucket->milliTokens < 1000) return 0;
+    bucket->milliTokens -= 1000;
+    return 1;
+}
@@ -0,0 +1,23 @@
+#ifndef RATELIMIT_H
+#define RATELIMIT_H
+
+#include <stdint.h>
+
+// Token bucket v tisícinách tokenu (bez float aritmetiky v horúcej ceste)
+typedef struct TokenBucket {
+    int64_t milliTokens;
+    int64_t lastMs;
+    int ratePerSec;     // Doplnenie tokenov za sekundu
+    int burst;          // Najviac tokenov naraz
+} token_bucket_t;
+
+// Monotónny čas v ms
+int64_t ratelimit_now_ms(void);
+
+// Plný bucket
+void bucket_init(token_bucket_t *bucket, int ratePerSec, int burst, int64_t nowMs);
+
+// Vezme token, vráti 1 ak bol k dispozícii, 0 ak treba požiadavku zahodiť
+int bucket_take(token_bucket_t *bucket, int64_t nowMs);
+
+#endif // RATELIMIT_H
@@ -9,108 +9,390 @@
 #include <time.h>
 #include <pthread.h>
 #include <errno.h>
+#include <stddef.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <linux/sockios.h>
 
 #include "shared.h"
 #include "game.h"
+#include "net.h"
+#include "lobby.h"
+#include "shard.h"
+#include "snapshot.h"
+#include "handover.h"
+#include "aoi.h"
+#include "pool.h"
+#include "uring.h"
+#include "ratelimit.h"
+#include "trace.h"
+#include "balance.h"
+#include "bot.h"
+#include "stats.h"
+#include "admission.h"
+
+// Buffre jedného spojenia, berú sa z poolu pri pripojení
+typedef struct ConnBuffer {
+    char rx[4 * sizeof(client_input_t)]; // Neúplné vstupy z TCP streamu
+    int rxUsed;
+    char tx[sizeof(msg_header_t) + VIEW_MAX_BYTES]; // Hlavička + zakódovaný výrez
+} conn_buffer_t;
+
+#define CONN_TX_PAYLOAD(io) ((io)->tx + sizeof(msg_header_t))
 
 typedef struct ClientSlot {
     int fd;
     int playerId;  // Unikátny ID hráča
-    int playerIdx; // index v games[gameId].snakes
+    int playerIdx; // index slotu v games[gameId]
     int gameId;    // ID hry, ktorej patrí klient
     int active;
+    aoi_subscription_t sub; // Čo klient videl v poslednom výreze
+    conn_buffer_t *io;
+    unsigned connId;        // Číslo spojenia (odlíši nového klienta v tom istom slote)
+
+    // Ochrana pred zaplavením vstupmi (iba hlavné vlákno)
+    token_bucket_t inputBucket;
+    int batchLeft;          // Vstupy, ktoré sa ešte spracujú v tejto iterácii slučky
+    long inputsHandled;
+    long inputsThrottled;   // Zahodené, prázdny token bucket
+    long inputsDropped;     // Zahodené, prekročený limit na iteráciu
+
+    // Telemetria spojenia (iba hlavné vlákno)
+    int64_t lastPingMs;
+    uint32_t pingStamp;     // Pečiatka posledného pingu bez odpovede, 0 = žiadny
+    int srttUs;             // Vyhladená RTT (ako TCP: 7/8 stará + 1/8 nová)
+    int jitterUs;           // Vyhladená odchýlka RTT (3/4 stará + 1/4 nová)
+    int sendQueue;          // Neodoslané bajty v sockete pri poslednom pingu
+    int sendQueueMax;
+    long pongs;
 } client_slot_t;
 
-static game_state_t games[MAX_PLAYERS];
+// Váhy rýchleho pripojenia: voľné miesto je ako tick lacnejší o QUICK_JOIN_SLOT_US
+// (počíta sa najviac QUICK_JOIN_MAX_SLOTS miest), rozdiel RTT sa delí QUICK_JOIN_RTT_DIV
+#define QUICK_JOIN_SLOT_US 50
+#define QUICK_JOIN_MAX_SLOTS 4
+#define QUICK_JOIN_RTT_DIV 10
+
+// Najviac spracovaných vstupov jedného klienta za iteráciu hlavnej slučky
+#define INPUT_BATCH_MAX 4
+// Nové spojenia z listenera: za sekundu a naraz
+#define ACCEPT_RATE 20
+#define ACCEPT_BURST 10
+
+// Hry sa berú z poolu pri vytvorení a vracajú pri skončení (NULL = voľné ID)
+static game_engine_t *games[MAX_PLAYERS];
+static pool_t gamePool;  // Pod gamesMutex
+static pool_t connPool;  // Pod clientsMutex
+static int gameThreadArgs[MAX_PLAYERS];
+static unsigned nextConnId = 0;  // Iba hlavné vlákno
+
+// Limit vstupov na klienta (-r) a počítadlá odpojených klientov a odmietnutých spojení
+static int inputRate = 20;
+static int listenBacklog = ADMISSION_BACKLOG;  // -q
+static token_bucket_t acceptBucket;
+static long totalThrottled = 0;
+static long totalDropped = 0;
+static long rejectedBusy[BUSY_REASON_COUNT];  // Iba hlavné vlákno
 static client_slot_t clients[MAX_PLAYERS];
 static int elapsedMs[MAX_PLAYERS] = {0};
 static pthread_t gameThreads[MAX_PLAYERS];
 static pthread_mutex_t gamesMutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_mutex_t clientsMutex = PTHREAD_MUTEX_INITIALIZER;
 
+// Index blokov pre výrezy (pod gamesMutex)
+static aoi_index_t aoiIndex[MAX_PLAYERS];
+static bot_group_t botGroups[MAX_PLAYERS];  // Pod gamesMutex
+static int botsAlive[MAX_PLAYERS];
+static int gameAvgRttUs[MAX_PLAYERS];  // Počíta broadcast_views, číta iba vlákno hry
 
+// Cache odpovede na LIST_GAMES, používa ju iba hlavné vlákno
+static game_list_t lobbyCache;
+static unsigned lobbyCacheGeneration = ~0u;
+
+static volatile sig_atomic_t stopRequested = 0;
+static volatile sig_atomic_t traceDumpRequested = 0;  // SIGUSR1
+
+// Aréna nových hier (-a) a vlákna pre fázu 1 ticku veľkých arén (-t)
+static int arenaWidth = WORLD_WIDTH;
+static int arenaHeight = WORLD_HEIGHT;
+static int arenaSnakes = MAX_PLAYERS;
+static int tickThreads = 0;
+static int botsPerGame = 0;   // -b: boty v každej novej hre
+static int arenaBots = 0;     // -B: záťažová aréna iba s botmi
+
+// io_uring backend (-u): hlavná slučka nad ringom, broadcasty jedným submitom za tick
+static int useUring = 0;
+static uring_t sendRing = {.fd = -1};  // Pod clientsMutex
+
+// Hot restart: riadiaci socket vedľa súboru so snapshotom
+static char controlPath[256];
+static int controlFd = -1;
 
 static int find_free_game_slot(void) {
     for (int i = 0; i < MAX_PLAYERS; i++) {
-        if (!games[i].gameRunning && games[i].playerCount == 0) {
+        if (!shard_owns(i)) continue;  // Hry iných shardov
+        if (!games[i]) {
             return i;
         }
     }
     return -1;
 }
 
-static void broadcast_to_game(int gameId) {
+// Pošle klientovi mimo hry výrez hry bez vlastného hadíka, napr. keď sa nepridal
+// (volať pod gamesMutex z hlavného vlákna, tx buffer klienta herné vlákna nepoužívajú)
+static void send_game_view(int client_idx, int gameId) {
+    if (!games[gameId]) {
+        // Voľný slot: prázdny výrez so skončenou hrou, klient sa vráti do menu
+        view_header_t empty;
+        memset(&empty, 0, sizeof(empty));
+        empty.gameId = gameId;
+        empty.selfSlot = -1;
+        empty.encoding = VIEW_ENC_LIST;
+        net_send_msg(clients[client_idx].fd, MSG_VIEW, &empty, sizeof(empty));
+        return;
+    }
+    aoi_subscription_t sub;
+    aoi_reset(&sub);
+    aoi_build_index(&aoiIndex[gameId], games[gameId]);
+    char *buf = CONN_TX_PAYLOAD(clients[client_idx].io);
+    int length = aoi_encode_view(&aoiIndex[gameId], games[gameId], -1, &sub, buf, VIEW_MAX_BYTES);
+    net_send_msg(clients[client_idx].fd, MSG_VIEW, buf, length);
+}
+
+// Odošle zakódované výrezy hráčom hry (volať pod clientsMutex). S io_uring idú
+// všetky sendy jedným io_uring_enter, inak jeden sendmsg na klienta.
+static void send_frames(int gameId, const int *lengths) {
+    if (sendRing.fd < 0) {
+        for (int i = 0; i < MAX_PLAYERS; i++) {
+            if (clients[i].active && clients[i].gameId == gameId) {
+                net_send_msg(clients[i].fd, MSG_VIEW, CONN_TX_PAYLOAD(clients[i].io), lengths[i]);
+            }
+        }
+        return;
+    }
+
+    int totals[MAX_PLAYERS];
+    int pending[MAX_PLAYERS] = {0};
+    unsigned queued = 0;
+    for (int i = 0; i < MAX_PLAYERS; i++) {
+        if (!clients[i].active || clients[i].gameId != gameId) continue;
+        totals[i] = net_put_header(clients[i].io->tx, MSG_VIEW, lengths[i]);
+        struct io_uring_sqe *sqe = uring_get_sqe(&sendRing);
+        if (!sqe) {
+            net_send_all(clients[i].fd, clients[i].io->tx, totals[i]);
+            continue;
+        }
+        uring_prep_send(sqe, clients[i].fd, clients[i].io->tx, (unsigned)totals[i], MSG_NOSIGNAL, (uint64_t)i);
+        pending[i] = 1;
+        queued++;
+    }
+
+    // Odoslanie bez čakania (EINTR opakuje uring_submit), čaká sa až v cykle
+    unsigned done = 0;
+    int ret = queued > 0 ? uring_submit(&sendRing, 0) : 0;
+    while (ret >= 0 && done < queued) {
+        struct io_uring_cqe *cqe = uring_peek_cqe(&sendRing);
+        if (!cqe) {
+            ret = uring_submit(&sendRing, 1);
+            if (ret < 0 && errno == EINTR) ret = 0;
+            continue;
+        }
+        int i = (int)cqe->user_data;
+        int sent = cqe->res;
+        uring_cqe_seen(&sendRing);
+        done++;
+        pending[i] = 0;
+        // Krátky send (plný socket buffer) dokonči synchrónne ako net_send_msg
+        if (sent >= 0 && sent < totals[i]) {
+            net_send_all(clients[i].fd, clients[i].io->tx + sent, totals[i] - sent);
+        }
+    }
+    if (ret < 0) {
+        // Ring je nepoužiteľný: zvyšok pošleme synchrónne a ďalšie snímky
+        // už pôjdu cez sendmsg
+        perror("io_uring send");
+        uring_close(&sendRing);
+        for (int i = 0; i < MAX_PLAYERS; i++) {
+            if (pending[i]) net_send_all(clients[i].fd, clients[i].io->tx, totals[i]);
+        }
+    }
+}
+
+// Pošle každému hráčovi hry jeho výrez. Volať pod gamesMutex, ktorý funkcia uvoľní
+// hneď po zakódovaní výrezov; odosiela sa už iba pod clientsMutex.
+static void broadcast_views(int gameId) {
+    int64_t t0 = trace_begin();
     pthread_mutex_lock(&clientsMutex);
+    trace_end("broadcast.lock_wait", t0);
+    game_engine_t *state = games[gameId];
+    int running = state->gameRunning;
+    int lengths[MAX_PLAYERS] = {0};
+
+    t0 = trace_begin();
+    aoi_build_index(&aoiIndex[gameId], state);
+    long rttSum = 0;
+    int rttCount = 0;
     for (int i = 0; i < MAX_PLAYERS; i++) {
         if (clients[i].active && clients[i].gameId == gameId) {
-            // Pošli stav všetkým hráčom
-            send(clients[i].fd, &games[gameId], sizeof(game_state_t), 0);
-            
-            // Ak je hra skončená, odpoji klienta z tejto hry
-            if (!games[gameId].gameRunning) {
-                clients[i].gameId = -1;
-                clients[i].playerIdx = -1;
-                printf("Client %d released from finished game %d\n", i, gameId);
+            lengths[i] = aoi_encode_view(&aoiIndex[gameId], state, clients[i].playerIdx,
+                                         &clients[i].sub, CONN_TX_PAYLOAD(clients[i].io), VIEW_MAX_BYTES);
+            if (clients[i].pongs > 0) {
+                rttSum += clients[i].srttUs;
+                rttCount++;
             }
         }
     }
+    gameAvgRttUs[gameId] = rttCount ? (int)(rttSum / rttCount) : 0;
+    pthread_mutex_unlock(&gamesMutex);
+    trace_end("broadcast.encode", t0);
+
+    t0 = trace_begin();
+    send_frames(gameId, lengths);
+    trace_end("broadcast.send", t0);
+    for (int i = 0; i < MAX_PLAYERS; i++) {
+        // Ak je hra skončená, odpoji klienta z tejto hry
+        if (!running && clients[i].active && clients[i].gameId == gameId) {
+            clients[i].gameId = -1;
+            clients[i].playerIdx = -1;
+            printf("Client %d released from finished game %d\n", i, gameId);
+        }
+    }
     pthread_mutex_unlock(&clientsMutex);
 }
 
+// Pošle aktuálny stav hry všetkým jej hráčom mimo ticku (po create/join)
+static void broadcast_current_state(int gameId) {
+    pthread_mutex_lock(&gamesMutex);
+    broadcast_views(gameId);
+}
+
 void* game_thread(void* arg) {
     int gid = *(int*)arg;
-    free(arg);
+    char threadName[32];
+    snprintf(threadName, sizeof(threadName), "game %d", gid);
+    trace_thread_name(threadName);
     
     printf("Game thread %d started\n", gid);
+    int appliedCore = -1;
+    uint32_t nextTickUs = net_clock_us();  // Plánovaný začiatok ticku
     
     while (1) {
+        balance_apply(gid, &appliedCore);
         pthread_mutex_lock(&gamesMutex);
+        uint32_t tickStart = net_clock_us();
+        admission_record_tick((int)(tickStart - nextTickUs));
         
-        if (!games[gid].gameRunning) {
+        if (!games[gid]->gameRunning) {
             printf("Game %d has no players, terminating thread\n", gid);
-            game_reset(&games[gid]);
+            lobby_clear(gid);
+            snapshot_clear(gid);
+            // Engine sa recykluje, game_init ho pri ďalšom vydaní prepíše
+            pool_free(&gamePool, games[gid]);
+            games[gid] = NULL;
+            stats_game_over(gid, elapsedMs[gid]);
             elapsedMs[gid] = 0;
+            balance_forget(gid);
+            bot_detach(&botGroups[gid]);
+            botsAlive[gid] = 0;
             pthread_mutex_unlock(&gamesMutex);
             break;
         }
         
-        game_tick(&games[gid]);
+        int64_t t0 = trace_begin();
+        if (botGroups[gid].count > 0) {
+            botsAlive[gid] = bot_think(&botGroups[gid], games[gid]);
+            trace_end("bots.think", t0);
+            t0 = trace_begin();
+        }
+        game_tick(games[gid]);
+        games[gid]->tickStampUs = net_clock_us();
+        trace_end("game.tick", t0);
         elapsedMs[gid] += GAME_LOOP_MS;
-        games[gid].elapsedTime = elapsedMs[gid] / 1000;
+        games[gid]->elapsedTime = elapsedMs[gid] / 1000;
         
-        pthread_mutex_unlock(&gamesMutex);
+        stats_track(gid, games[gid], elapsedMs[gid]);
+        game_summary_t summary;
+        lobby_summarize(games[gid], &summary);
+        t0 = trace_begin();
+        snapshot_store(gid, games[gid], elapsedMs[gid]);
+        trace_end("snapshot.store", t0);
+        broadcast_views(gid); // Uvoľní gamesMutex
         
-        broadcast_to_game(gid);
+        // Cena ticku bez čakania na zámok: tick, snapshot, kódovanie a odoslanie výrezov
+        balance_record_tick(gid, (int)(net_clock_us() - tickStart));
+        summary.tickCostUs = balance_tick_cost(gid);
+        summary.avgRttUs = gameAvgRttUs[gid];
+        lobby_publish(gid, &summary);
         
-        usleep(GAME_LOOP_MS * 1000);
+        // Ticky idú podľa plánu, cena ticku tempo nespomalí; po veľkom
+        // meškaní sa plán posunie namiesto dobiehania tickov za sebou
+        nextTickUs += GAME_LOOP_MS * 1000;
+        int sleepUs = (int)(nextTickUs - net_clock_us());
+        if (sleepUs > 0) {
+            usleep((useconds_t)sleepUs);
+        } else {
+            nextTickUs = net_clock_us();
+        }
     }
     
     printf("Game thread %d ended\n", gid);
     return NULL;
 }
 
-static int create_new_game(void) {
+// Spusti vlákno pre túto hru
+static int start_game_thread(int gid) {
+    gameThreadArgs[gid] = gid;
+    if (pthread_create(&gameThreads[gid], NULL, game_thread, &gameThreadArgs[gid]) != 0) {
+        perror("pthread_create failed");
+        return -1;
+    }
+    pthread_detach(gameThreads[gid]);
+    return 0;
+}
+
+// Nová hra, voliteľne s botmi (persistent=1: beží aj bez ľudí). Ak pidx nie je
+// NULL, hráč playerId sa pridá ešte pred štartom vlákna (inak by vlákno prázdnej
+// hry mohlo engine hneď uvoľniť) a jeho slot sa vráti v *pidx
+static int create_new_game(int playerId, int bots, int persistent, int *pidx) {
     int gid = find_free_game_slot();
     if (gid < 0) return -1;
     
     pthread_mutex_lock(&gamesMutex);
-    game_init(&games[gid]);
-    games[gid].gameId = gid;
+    game_engine_t *state = pool_alloc(&gamePool);
+    if (!state) {
+        pthread_mutex_unlock(&gamesMutex);
+        return -1;
+    }
+    game_init(state);
+    game_configure(state, arenaWidth, arenaHeight, arenaSnakes);
+    state->gameId = gid;
+    games[gid] = state;
+    if (pidx) *pidx = game_add_player(state, playerId);
+    // Boty sa objavia ešte pred prvým tickom, hra teda hneď beží
+    if (bots > 0 && bot_attach(&botGroups[gid], state, bots, persistent) == 0) {
+        botsAlive[gid] = bot_think(&botGroups[gid], state);
+    }
     pthread_mutex_unlock(&gamesMutex);
     
-    // Spusti vlákno pre túto hru
-    int *arg = malloc(sizeof(int));
-    *arg = gid;
-    if (pthread_create(&gameThreads[gid], NULL, game_thread, arg) != 0) {
-        perror("pthread_create failed");
-        free(arg);
+    if (start_game_thread(gid) < 0) {
+        pthread_mutex_lock(&gamesMutex);
+        bot_detach(&botGroups[gid]);
+        pool_free(&gamePool, state);
+        games[gid] = NULL;
+        pthread_mutex_unlock(&gamesMutex);
         return -1;
     }
-    pthread_detach(gameThreads[gid]);
-    
     return gid;
 }
 
+// Odstráni hráča-klienta z hry (volajúci drží gamesMutex); boty sa vymieňajú potichu
+static void remove_player(int gid, int pidx, int permanent) {
+    printf("Removing player %d from game %d (permanent=%d)\n", pidx, gid, permanent);
+    game_remove_player(games[gid], pidx, permanent);
+}
+
 static void remove_client(int client_idx) {
     if (client_idx < 0 || client_idx >= MAX_PLAYERS) return;
     
@@ -125,15 +407,70 @@ static void remove_client(int client_idx) {
     
     close(clients[client_idx].fd);
     clients[client_idx].active = 0;
+    totalThrottled += clients[client_idx].inputsThrottled;
+    totalDropped += clients[client_idx].inputsDropped;
+    pool_free(&connPool, clients[client_idx].io);
+    clients[client_idx].io = NULL;
     pthread_mutex_unlock(&clientsMutex);
     
     if (gid >= 0) {
         pthread_mutex_lock(&gamesMutex);
-        game_remove_player(&games[gid], pidx, 0);  // 0 = hráč sa môže vrátiť
+        if (games[gid]) remove_player(gid, pidx, 0);  // 0 = hráč sa môže vrátiť
         pthread_mutex_unlock(&gamesMutex);
     }
 }
 
+// Odpovie na LIST_GAMES zo snapshotu lobby, bez herných zámkov
+// Obnoví lokálnu kópiu lobby, iba ak sa od posledného čítania zmenila
+static void refresh_lobby_cache(void) {
+    unsigned gen = lobby_generation();
+    if (gen != lobbyCacheGeneration) {
+        lobby_snapshot(&lobbyCache);
+        lobbyCacheGeneration = gen;
+    }
+}
+
+static void send_game_list(int client_idx) {
+    refresh_lobby_cache();
+    int length = (int)(offsetof(game_list_t, games) + lobbyCache.count * sizeof(game_summary_t));
+    net_send_msg(clients[client_idx].fd, MSG_GAME_LIST, &lobbyCache, length);
+}
+
+// Rebríček z tabuľky štatistík (zdieľaná všetkými shardmi), bez herných zámkov
+static void send_leaderboard(int client_idx, int playerId) {
+    leaderboard_t board;
+    stats_leaderboard(playerId, &board);
+    int length = (int)(offsetof(leaderboard_t, top) + board.count * sizeof(player_stats_t));
+    net_send_msg(clients[client_idx].fd, MSG_LEADERBOARD, &board, length);
+}
+
+// Najlepšia bežiaca hra pre rýchle pripojenie (zo všetkých shardov), -1 ak žiadna nemá miesto.
+// Nižšie skóre je lepšie: cena ticku hry, mínus bonus za voľné miesta, plus rozdiel
+// RTT klienta oproti priemeru hráčov hry (hráči s podobným pingom spolu).
+static int pick_quick_join_game(int client_idx) {
+    pthread_mutex_lock(&clientsMutex);
+    int rttUs = clients[client_idx].pongs > 0 ? clients[client_idx].srttUs : 0;
+    pthread_mutex_unlock(&clientsMutex);
+
+    refresh_lobby_cache();
+    int best = -1;
+    long bestScore = 0;
+    for (int k = 0; k < lobbyCache.count; k++) {
+        const game_summary_t *gs = &lobbyCache.games[k];
+        if (gs->freeSlots <= 0 || gs->gameId < 0 || gs->gameId >= MAX_PLAYERS) continue;
+        int freeSlots = gs->freeSlots < QUICK_JOIN_MAX_SLOTS ? gs->freeSlots : QUICK_JOIN_MAX_SLOTS;
+        long score = gs->tickCostUs - (long)freeSlots * QUICK_JOIN_SLOT_US;
+        if (rttUs > 0 && gs->avgRttUs > 0) {
+            score += labs((long)gs->avgRttUs - rttUs) / QUICK_JOIN_RTT_DIV;
+        }
+        if (best < 0 || score < bestScore) {
+            best = gs->gameId;
+            bestScore = score;
+        }
+    }
+    return best;
+}
+
 static void process_input_wrapper(int client_idx, const client_input_t *input) {
     pthread_mutex_lock(&clientsMutex);
     if (client_idx < 0 || !clients[client_idx].active) {
@@ -145,11 +482,17 @@ static void process_input_wrapper(int client_idx, const client_input_t *input) {
     int playerId = clients[client_idx].playerId;
     pthread_mutex_unlock(&clientsMutex);
     
+    int64_t t0 = trace_begin();
     pthread_mutex_lock(&gamesMutex);
+    trace_end("input.lock_wait", t0);
+    if (gid < 0 || !games[gid]) {
+        pthread_mutex_unlock(&gamesMutex);
+        return;
+    }
     
     // Keď mŕtvy hráč AKÁKOĽVEK AKCIU vykoná, oslobodíme ho z hry
-    if (pidx >= 0 && pidx < MAX_PLAYERS && !games[gid].snakes[pidx].alive) {
-        game_remove_player(&games[gid], pidx, 1);  // 1 = permanent
+    if (pidx >= 0 && pidx < games[gid]->maxSnakes && !game_player_alive(games[gid], pidx)) {
+        remove_player(gid, pidx, 1);  // 1 = permanent
         pthread_mutex_unlock(&gamesMutex);
         
         pthread_mutex_lock(&clientsMutex);
@@ -159,32 +502,35 @@ static void process_input_wrapper(int client_idx, const client_input_t *input) {
         return;
     }
     
-    game_process_input(&games[gid], playerId, input);
+    game_process_input(games[gid], playerId, input);
     pthread_mutex_unlock(&gamesMutex);
 }
 
-int main(void) {
-    srand((unsigned int)time(NULL));
-    
-    // Inicializuj prázdne štruktúry (hry sa vytvoria na požiadanie)
-    memset(games, 0, sizeof(games));
-    
-    for (int i = 0; i < MAX_PLAYERS; i++) {
-        clients[i].fd = -1;
-        clients[i].playerId = -1;
-        clients[i].playerIdx = -1;
-        clients[i].gameId = -1;
-        clients[i].active = 0;
-    }
+static void handle_stop_signal(int sig) {
+    (void)sig;
+    stopRequested = 1;
+}
+
+static void handle_trace_signal(int sig) {
+    (void)sig;
+    traceDumpRequested = 1;
+}
 
+// Vytvorí počúvajúci socket; pri shardingu ho zdieľajú workery cez SO_REUSEPORT
+static int open_listener(int reusePort) {
     int serverFd = socket(AF_INET, SOCK_STREAM, 0);
     if (serverFd < 0) {
         perror("socket failed");
-        return 1;
+        return -1;
     }
 
     int opt = 1;
     setsockopt(serverFd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+    if (reusePort && setsockopt(serverFd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
+        perror("SO_REUSEPORT failed");
+        close(serverFd);
+        return -1;
+    }
 
     struct sockaddr_in addr;
     memset(&addr, 0, sizeof(addr));
@@ -195,24 +541,606 @@ int main(void) {
     if (bind(serverFd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
         perror("bind failed");
         close(serverFd);
-        return 1;
+        return -1;
     }
     
-    if (listen(serverFd, 8) < 0) {
+    if (listen(serverFd, listenBacklog) < 0) {
         perror("listen failed");
         close(serverFd);
-        return 1;
+        return -1;
     }
+    return serverFd;
+}
 
-    printf("Server listening on port %d\n", PORT);
-    printf("Press 'q' and Enter to shutdown the server...\n");
+static void reset_telemetry(client_slot_t *client) {
+    client->lastPingMs = 0;
+    client->pingStamp = 0;
+    client->srttUs = 0;
+    client->jitterUs = 0;
+    client->sendQueue = 0;
+    client->sendQueueMax = 0;
+    client->pongs = 0;
+}
+
+static void reset_input_limits(client_slot_t *client) {
+    bucket_init(&client->inputBucket, inputRate, inputRate, ratelimit_now_ms());
+    client->batchLeft = INPUT_BATCH_MAX;
+    client->inputsHandled = 0;
+    client->inputsThrottled = 0;
+    client->inputsDropped = 0;
+}
+
+// Odmietne spojenie správou MSG_BUSY a zatvorí ho. Nový socket má prázdny
+// buffer, takže krátka správa sa odošle bez čakania.
+static void reject_busy(int cfd, busy_reason_t reason, int retryAfterMs) {
+    char msg[sizeof(msg_header_t) + sizeof(busy_t)];
+    busy_t busy = {reason, retryAfterMs};
+    int total = net_put_header(msg, MSG_BUSY, sizeof(busy));
+    memcpy(msg + sizeof(msg_header_t), &busy, sizeof(busy));
+    send(cfd, msg, (size_t)total, MSG_NOSIGNAL | MSG_DONTWAIT);
+    close(cfd);
+    rejectedBusy[reason]++;
+}
+
+// Zaradí nového klienta do tabuľky, vráti slot alebo -1 (spojenie odmietne)
+static int add_client(int cfd) {
+    pthread_mutex_lock(&clientsMutex);
+    int slot = -1;
+    for (int i = 0; i < MAX_PLAYERS; i++) {
+        if (!clients[i].active) {
+            slot = i;
+            break;
+        }
+    }
+    conn_buffer_t *io = slot >= 0 ? pool_alloc(&connPool) : NULL;
+    if (io) {
+        io->rxUsed = 0;
+        clients[slot].io = io;
+        clients[slot].connId = ++nextConnId;
+        reset_input_limits(&clients[slot]);
+        reset_telemetry(&clients[slot]);
+        clients[slot].fd = cfd;
+        clients[slot].gameId = -1;
+        clients[slot].playerIdx = -1;
+        clients[slot].active = 1;
+        aoi_reset(&clients[slot].sub);
+        printf("Client %d connected, waiting for action\n", slot);
+    } else {
+        slot = -1;
+        reject_busy(cfd, BUSY_FULL, ADMISSION_RETRY_MS);
+        printf("Rejected connection, server full\n");
+    }
+    pthread_mutex_unlock(&clientsMutex);
+    return slot;
+}
+
+// Odovzdá klienta shardu, ktorý vlastní hru; slot sa uvoľní bez zásahu do hier
+static int forward_client(int i, const client_input_t *in) {
+    if (shard_forward_client(clients[i].fd, in) < 0) return -1;
+
+    pthread_mutex_lock(&clientsMutex);
+    close(clients[i].fd);
+    clients[i].active = 0;
+    totalThrottled += clients[i].inputsThrottled;
+    totalDropped += clients[i].inputsDropped;
+    pool_free(&connPool, clients[i].io);
+    clients[i].io = NULL;
+    pthread_mutex_unlock(&clientsMutex);
+    printf("Client %d handed off to shard %d (game %d)\n", i, shard_owner(in->gameId), in->gameId);
+    return 0;
+}
+
+static void handle_client_input(int i, const client_input_t *input) {
+    client_input_t in = *input;
+
+    // Ulož player_id z vstupu
+    pthread_mutex_lock(&clientsMutex);
+    clients[i].playerId = in.playerId;
+    int has_game = clients[i].gameId >= 0;
+    int oldGameId = clients[i].gameId;
+    int oldPlayerIdx = clients[i].playerIdx;
+    pthread_mutex_unlock(&clientsMutex);
     
-    while (1) {
+    // Zoznam hier je dostupný vždy, aj počas hry
+    if (in.action == ACTION_LIST_GAMES) {
+        send_game_list(i);
+    }
+    else if (in.action == ACTION_LEADERBOARD) {
+        send_leaderboard(i, in.playerId);
+    }
+    // Rýchle pripojenie: server vyberie hru a pokračuje ako JOIN (aj do iného shardu) alebo CREATE
+    else if (!has_game && in.action == ACTION_QUICK_JOIN) {
+        int gid = pick_quick_join_game(i);
+        if (gid >= 0) {
+            in.action = ACTION_JOIN_GAME;
+            in.gameId = gid;
+            printf("Client %d quick join -> game %d\n", i, gid);
+        } else {
+            in.action = ACTION_CREATE_GAME;
+            printf("Client %d quick join -> new game\n", i);
+        }
+        handle_client_input(i, &in);
+    }
+    // Ak klient chce odísť zo svojej hry
+    else if (has_game && in.action == ACTION_QUIT) {
+        pthread_mutex_lock(&gamesMutex);
+        if (games[oldGameId]) remove_player(oldGameId, oldPlayerIdx, 1);  // 1 = úplné oslobodenie
+        pthread_mutex_unlock(&gamesMutex);
+        
+        pthread_mutex_lock(&clientsMutex);
+        clients[i].gameId = -1;
+        clients[i].playerIdx = -1;
+        pthread_mutex_unlock(&clientsMutex);
+        
+        printf("Client %d quit game %d\n", i, oldGameId);
+    }
+    // Vytvor novú hru (quit volaný pred týmto)
+    else if (!has_game && in.action == ACTION_CREATE_GAME) {
+        int pidx = -1;
+        int gid = create_new_game(in.playerId, botsPerGame, 0, &pidx);
+        if (gid >= 0) {
+            if (pidx >= 0) {
+                pthread_mutex_lock(&clientsMutex);
+                clients[i].playerId = in.playerId;
+                clients[i].gameId = gid;
+                clients[i].playerIdx = pidx;
+                aoi_reset(&clients[i].sub);
+                pthread_mutex_unlock(&clientsMutex);
+                
+                printf("Client %d created game %d\n", i, gid);
+                usleep(500000);
+                broadcast_current_state(gid);
+            } else {
+                printf("Player %d cannot create game (dead/full)\n", in.playerId);
+                pthread_mutex_lock(&gamesMutex);
+                send_game_view(i, gid);
+                pthread_mutex_unlock(&gamesMutex);
+            }
+        }
+    }
+    // Hra patrí inému shardu - odovzdaj mu spojenie aj s týmto vstupom
+    else if (!has_game && in.action == ACTION_JOIN_GAME &&
+             in.gameId >= 0 && in.gameId < MAX_PLAYERS && !shard_owns(in.gameId) &&
+             forward_client(i, &in) == 0) {
+        return;
+    }
+    // Pripoj sa k existujúcej hre (klient už poslal QUIT pred týmto)
+    else if (!has_game && in.action == ACTION_JOIN_GAME) {
+        int gid = in.gameId;
+        pthread_mutex_lock(&gamesMutex);
+        int can_join = (gid >= 0 && gid < MAX_PLAYERS && games[gid] && games[gid]->gameRunning);
+        int pidx = -1;
+        if (can_join) {
+            pidx = game_add_player(games[gid], in.playerId);
+        }
+        pthread_mutex_unlock(&gamesMutex);
+        
+        if (pidx >= 0) {
+            pthread_mutex_lock(&clientsMutex);
+            clients[i].playerId = in.playerId;
+            clients[i].gameId = gid;
+            clients[i].playerIdx = pidx;
+            aoi_reset(&clients[i].sub);
+            pthread_mutex_unlock(&clientsMutex);
+            printf("Client %d joined game %d\n", i, gid);
+            usleep(500000);
+            broadcast_current_state(gid);
+        } else {
+            printf("Client %d cannot join game %d (result=%d)\n", i, gid, pidx);
+            // Pošli stav hry aby vedel, že sa nepridá
+            if (gid >= 0 && gid < MAX_PLAYERS) {
+                pthread_mutex_lock(&gamesMutex);
+                send_game_view(i, gid);
+                pthread_mutex_unlock(&gamesMutex);
+            }
+        }
+    }
+    // Iné akcie (MOVE, PAUSE) spracuj v aktívnej hre
+    else if (has_game) {
+        process_input_wrapper(i, &in);
+    }
+}
+
+// Odpoveď na ping: aktualizuje RTT a jitter klienta (stará alebo cudzia pečiatka sa ignoruje)
+static void note_pong(int i, uint32_t stamp) {
+    client_slot_t *c = &clients[i];
+    if (c->pingStamp == 0 || stamp != c->pingStamp) return;
+    c->pingStamp = 0;
+    int sample = (int)(net_clock_us() - stamp);
+    pthread_mutex_lock(&clientsMutex); // RTT číta aj vlákno hry (priemer pre lobby)
+    if (c->pongs++ == 0) {
+        c->srttUs = sample;
+        c->jitterUs = sample / 2;
+    } else {
+        int dev = sample > c->srttUs ? sample - c->srttUs : c->srttUs - sample;
+        c->jitterUs += (dev - c->jitterUs) / 4;
+        c->srttUs += (sample - c->srttUs) / 8;
+    }
+    pthread_mutex_unlock(&clientsMutex);
+}
+
+// Raz za PING_INTERVAL_MS pošle každému klientovi ping s jeho poslednými meraniami
+// a odmeria, koľko bajtov mu server ešte nestihol odoslať
+static void send_pings(void) {
+    int64_t now = ratelimit_now_ms();
+    pthread_mutex_lock(&clientsMutex);
+    for (int i = 0; i < MAX_PLAYERS; i++) {
+        client_slot_t *c = &clients[i];
+        if (!c->active || now - c->lastPingMs < PING_INTERVAL_MS) continue;
+        c->lastPingMs = now;
+
+        int queued = 0;
+        if (ioctl(c->fd, SIOCOUTQ, &queued) == 0) {
+            c->sendQueue = queued;
+            if (queued > c->sendQueueMax) c->sendQueueMax = queued;
+        }
+
+        ping_t ping;
+        ping.stamp = net_clock_us();
+        if (ping.stamp == 0) ping.stamp = 1; // 0 znamená "bez pingu"
+        ping.rttUs = c->srttUs;
+        ping.jitterUs = c->jitterUs;
+        ping.sendQueue = c->sendQueue;
+        c->pingStamp = ping.stamp; // Nezodpovedaný ping sa prepíše novým
+        net_send_msg(c->fd, MSG_PING, &ping, sizeof(ping));
+    }
+    pthread_mutex_unlock(&clientsMutex);
+}
+
+// Nové spojenie z listenera. Pri nárazovom pripájaní, plnej tabuľke alebo
+// meškajúcich tickoch ho odmietne s časom na nový pokus; prijatému klientovi
+// hneď pošle ping, podľa ktorého klient spozná, že bol prijatý.
+static void accept_client(int cfd) {
+    int64_t t0 = trace_begin();
+    int64_t now = ratelimit_now_ms();
+    int freeSlots = 0, queued = 0;
+    pthread_mutex_lock(&clientsMutex);
+    for (int i = 0; i < MAX_PLAYERS; i++) {
+        if (clients[i].active) {
+            queued += clients[i].sendQueue;
+        } else {
+            freeSlots++;
+        }
+    }
+    pthread_mutex_unlock(&clientsMutex);
+
+    busy_reason_t reason;
+    int retryAfterMs = admission_check(now, freeSlots, queued, &reason);
+    if (retryAfterMs == 0 && !bucket_take(&acceptBucket, now)) {
+        reason = BUSY_RATE;
+        retryAfterMs = ADMISSION_RETRY_MS;
+    }
+    if (retryAfterMs > 0) {
+        reject_busy(cfd, reason, retryAfterMs);
+    } else if (add_client(cfd) >= 0) {
+        send_pings();
+    }
+    trace_end("accept", t0);
+}
+
+// Spracuje všetky celé vstupy v rx bufferi klienta. Vstupy nad limit iterácie
+// alebo bez tokenu sa zahodia, aby jeden klient nezahltil slučku ani zámky hier.
+static void process_client_rx(int i) {
+    conn_buffer_t *io = clients[i].io;
+    int64_t now = ratelimit_now_ms();
+    int pos = 0;
+    while (io->rxUsed - pos >= (int)sizeof(client_input_t)) {
+        client_input_t in;
+        memcpy(&in, io->rx + pos, sizeof(in));
+        pos += (int)sizeof(in);
+        if (in.action == ACTION_PONG) {
+            note_pong(i, in.stamp); // Mimo limitov, inak by zahltený klient nemal RTT
+            continue;
+        }
+        if (clients[i].batchLeft <= 0) {
+            clients[i].inputsDropped++;
+            continue;
+        }
+        clients[i].batchLeft--;
+        if (!bucket_take(&clients[i].inputBucket, now)) {
+            clients[i].inputsThrottled++;
+            continue;
+        }
+        clients[i].inputsHandled++;
+        handle_client_input(i, &in);
+        if (!clients[i].active) return; // Odovzdaný inému shardu
+    }
+    io->rxUsed -= pos;
+    memmove(io->rx, io->rx + pos, (size_t)io->rxUsed);
+}
+
+// Dočíta dáta klienta do jeho rx buffera a spracuje ich, vráti -1 pri odpojení
+static int read_client_inputs(int i) {
+    conn_buffer_t *io = clients[i].io;
+    ssize_t n = recv(clients[i].fd, io->rx + io->rxUsed, sizeof(io->rx) - (size_t)io->rxUsed, 0);
+    if (n <= 0) return -1;
+    io->rxUsed += (int)n;
+    process_client_rx(i);
+    return 0;
+}
+
+// Prijaté bajty z io_uring buffera (môže ich byť viac, než sa zmestí do rx naraz)
+static void feed_client_bytes(int i, const char *data, int length) {
+    while (length > 0 && clients[i].active) {
+        conn_buffer_t *io = clients[i].io;
+        int room = (int)sizeof(io->rx) - io->rxUsed;
+        int chunk = length < room ? length : room;
+        memcpy(io->rx + io->rxUsed, data, (size_t)chunk);
+        io->rxUsed += chunk;
+        data += chunk;
+        length -= chunk;
+        process_client_rx(i);
+    }
+}
+
+// Starý proces: zastaví ticky, uloží checkpoint a odovzdá deskriptory novej binárke.
+// Vráti 0 ak nový proces prevzal server (tento proces má skončiť).
+static int perform_handover(int ctlConn, int serverFd) {
+    // Herné vlákna zostanú stáť na gamesMutex, kým proces neskončí
+    pthread_mutex_lock(&gamesMutex);
+    pthread_mutex_lock(&clientsMutex);
+
+    for (int g = 0; g < MAX_PLAYERS; g++) {
+        if (games[g] && games[g]->gameRunning) {
+            snapshot_store(g, games[g], elapsedMs[g]);
+        } else {
+            snapshot_clear(g);
+        }
+    }
+    snapshot_sync();  // Checkpoint je na disku, aj keby nový proces hneď padol
+
+    handover_info_t info;
+    memset(&info, 0, sizeof(info));
+    int fds[MAX_PLAYERS];
+    for (int i = 0; i < MAX_PLAYERS; i++) {
+        if (!clients[i].active) continue;
+        handover_client_t *hc = &info.clients[info.clientCount];
+        hc->playerId = clients[i].playerId;
+        hc->playerIdx = clients[i].playerIdx;
+        hc->gameId = clients[i].gameId;
+        fds[info.clientCount++] = clients[i].fd;
+    }
+
+    if (handover_send(ctlConn, serverFd, fds, &info) < 0) {
+        printf("Handover failed, continuing\n");
+        pthread_mutex_unlock(&clientsMutex);
+        pthread_mutex_unlock(&gamesMutex);
+        return -1;
+    }
+    printf("Handed over %d clients to new server\n", info.clientCount);
+    return 0;
+}
+
+// Boty prevzatej hry dostanú späť riadenie; hra bez ľudí je záťažová aréna
+static void restore_bots(int gid) {
+    const game_engine_t *state = games[gid];
+    int bots = 0;
+    int humans = 0;
+    for (int i = 0; i < state->maxSnakes; i++) {
+        int id = state->playerId[i];
+        if (IS_BOT_PLAYER(id) && BOT_PLAYER_ID(0) - id + 1 > bots) bots = BOT_PLAYER_ID(0) - id + 1;
+        if (id >= 0) humans++;
+    }
+    if (bots > 0) bot_attach(&botGroups[gid], state, bots, humans == 0);
+}
+
+// Nový proces: prevezme listener a klientov, obnoví hry zo snapshotu.
+// Vráti počúvajúci socket alebo -1.
+static int restore_from_handover(void) {
+    int serverFd = -1;
+    int fds[MAX_PLAYERS];
+    handover_info_t info;
+    if (handover_request(controlPath, &serverFd, fds, &info) < 0) {
+        fprintf(stderr, "Takeover from %s failed\n", controlPath);
+        return -1;
+    }
+
+    pthread_mutex_lock(&gamesMutex);
+    for (int g = 0; g < MAX_PLAYERS; g++) {
+        game_engine_t *state = pool_alloc(&gamePool);
+        if (!state) {
+            printf("Game %d not restored, game pool exhausted\n", g);
+            continue;
+        }
+        if (!snapshot_load(g, state, &elapsedMs[g])) {
+            pool_free(&gamePool, state);
+            continue;
+        }
+        state->gameId = g;
+        games[g] = state;
+        restore_bots(g);
+    }
+    pthread_mutex_unlock(&gamesMutex);
+
+    // Tabuľka klientov musí byť hotová skôr, než ju začnú čítať herné vlákna
+    pthread_mutex_lock(&clientsMutex);
+    for (int i = 0; i < info.clientCount && i < MAX_PLAYERS; i++) {
+        const handover_client_t *hc = &info.clients[i];
+        clients[i].io = pool_alloc(&connPool);
+        if (!clients[i].io) {
+            close(fds[i]);
+            printf("Rejected taken over client %d, connection pool exhausted\n", i);
+            continue;
+        }
+        clients[i].io->rxUsed = 0;
+        clients[i].connId = ++nextConnId;
+        reset_input_limits(&clients[i]);
+        reset_telemetry(&clients[i]);
+        clients[i].fd = fds[i];
+        clients[i].playerId = hc->playerId;
+        clients[i].gameId = hc->gameId;
+        clients[i].playerIdx = hc->playerIdx;
+        clients[i].active = 1;
+        aoi_reset(&clients[i].sub);
+        // Hra, ktorá v snapshote nebola, už neexistuje
+        if (clients[i].gameId < 0 || clients[i].gameId >= MAX_PLAYERS ||
+            !games[clients[i].gameId]) {
+            clients[i].gameId = -1;
+            clients[i].playerIdx = -1;
+        }
+    }
+    pthread_mutex_unlock(&clientsMutex);
+
+    int restored = 0;
+    for (int g = 0; g < MAX_PLAYERS; g++) {
+        if (games[g] && start_game_thread(g) == 0) restored++;
+    }
+    printf("Took over %d clients and %d games\n", info.clientCount, restored);
+    return serverFd;
+}
+
+// Nová iterácia slučky: každý klient môže opäť poslať INPUT_BATCH_MAX vstupov
+static void refill_input_batches(void) {
+    for (int i = 0; i < MAX_PLAYERS; i++) {
+        clients[i].batchLeft = INPUT_BATCH_MAX;
+    }
+}
+
+static void print_input_stats(void) {
+    pthread_mutex_lock(&clientsMutex);
+    printf("Input limits: %d/s per client, %d per loop iteration\n", inputRate, INPUT_BATCH_MAX);
+    long throttled = totalThrottled;
+    long dropped = totalDropped;
+    for (int i = 0; i < MAX_PLAYERS; i++) {
+        if (!clients[i].active) continue;
+        printf("  client %d: handled %ld, throttled %ld, dropped %ld\n", i,
+               clients[i].inputsHandled, clients[i].inputsThrottled, clients[i].inputsDropped);
+        throttled += clients[i].inputsThrottled;
+        dropped += clients[i].inputsDropped;
+    }
+    printf("  total throttled %ld, dropped %ld\n", throttled, dropped);
+    int64_t late = admission_last_late_ms();
+    printf("Admission: backlog %d, rejected full %ld, overload %ld, rate %ld\n", listenBacklog,
+           rejectedBusy[BUSY_FULL], rejectedBusy[BUSY_OVERLOAD], rejectedBusy[BUSY_RATE]);
+    if (late) printf("  last late tick %.1f s ago\n", (ratelimit_now_ms() - late) / 1000.0);
+    pthread_mutex_unlock(&clientsMutex);
+}
+
+static void print_game_stats(void) {
+    pthread_mutex_lock(&gamesMutex);
+    printf("Player stats: %d players, %ld records dropped\n", stats_player_count(), stats_dropped());
+    printf("Games (balanced over %d cores):\n", balance_cpu_count());
+    for (int g = 0; g < MAX_PLAYERS; g++) {
+        if (!games[g]) continue;
+        char core[16] = "any";
+        if (balance_core(g) >= 0) snprintf(core, sizeof(core), "%d", balance_core(g));
+        printf("  game %d: %d players (%d bots), tick %d us, avg rtt %.2f ms, core %s\n", g,
+               games[g]->playerCount, botsAlive[g], balance_tick_cost(g), gameAvgRttUs[g] / 1000.0, core);
+        if (botGroups[g].count > 0) {
+            printf("    bot field %dx%d, %d cells updated last tick\n", games[g]->width, games[g]->height,
+                   bot_field_work(&botGroups[g]));
+        }
+    }
+    pthread_mutex_unlock(&gamesMutex);
+}
+
+// Rozdelí bežiace hry na jadrá podľa ceny ticku (sama sa obmedzí na BALANCE_INTERVAL_MS)
+static void rebalance_games(void) {
+    if (balance_cpu_count() < 2) return;
+    int running[MAX_PLAYERS];
+    pthread_mutex_lock(&gamesMutex);
+    for (int g = 0; g < MAX_PLAYERS; g++) {
+        running[g] = games[g] && games[g]->gameRunning;
+    }
+    pthread_mutex_unlock(&gamesMutex);
+    balance_rebalance(running, ratelimit_now_ms());
+}
+
+static void print_net_stats(void) {
+    pthread_mutex_lock(&clientsMutex);
+    printf("Network (ping every %d ms):\n", PING_INTERVAL_MS);
+    for (int i = 0; i < MAX_PLAYERS; i++) {
+        const client_slot_t *c = &clients[i];
+        if (!c->active) continue;
+        if (c->pongs == 0) {
+            printf("  client %d: rtt n/a, send queue %d B (max %d B)\n", i, c->sendQueue, c->sendQueueMax);
+            continue;
+        }
+        printf("  client %d: rtt %.2f ms, jitter %.2f ms, send queue %d B (max %d B), pongs %ld%s\n", i,
+               c->srttUs / 1000.0, c->jitterUs / 1000.0, c->sendQueue, c->sendQueueMax, c->pongs,
+               c->pingStamp ? ", ping pending" : "");
+    }
+    pthread_mutex_unlock(&clientsMutex);
+}
+
+// Zapíše trace do trace-<pid>.json (príkaz 'd' alebo SIGUSR1)
+static void dump_trace(void) {
+    char path[64];
+    snprintf(path, sizeof(path), "trace-%d.json", (int)getpid());
+    int events = trace_dump(path);
+    if (events < 0) {
+        perror("trace dump failed");
+    } else {
+        printf("Trace: %d events written to %s\n", events, path);
+    }
+}
+
+// Volá hlavná slučka po každom zobudení
+static void check_trace_dump(void) {
+    if (!traceDumpRequested) return;
+    traceDumpRequested = 0;
+    dump_trace();
+}
+
+// Príkaz operátora zo stdin ('q' vypnutie, 's' štatistiky, 't' tracing, 'd' výpis trace),
+// vráti 1 ak sa má server vypnúť
+static int handle_stdin(void) {
+    char ch;
+    if (read(STDIN_FILENO, &ch, 1) <= 0) return 0;
+    if (ch == 'q' || ch == 'Q') {
+        printf("\nShutting down server...\n");
+        return 1;
+    }
+    if (ch == 's' || ch == 'S') {
+        print_input_stats();
+        print_net_stats();
+        print_game_stats();
+    } else if (ch == 't' || ch == 'T') {
+        trace_set_enabled(!trace_enabled());
+        printf("Tracing %s\n", trace_enabled() ? "enabled" : "disabled");
+    } else if (ch == 'd' || ch == 'D') {
+        dump_trace();
+    }
+    return 0;
+}
+
+// Nová binárka žiada o prevzatie servera, vráti 1 ak ho prevzala
+static int handle_control(int serverFd) {
+    int ctlConn = accept(controlFd, NULL, NULL);
+    if (ctlConn < 0) return 0;
+    int done = perform_handover(ctlConn, serverFd) == 0;
+    close(ctlConn);
+    return done;
+}
+
+// Klient odovzdaný iným shardom - spracuj jeho JOIN tu
+static void handle_inbox(void) {
+    client_input_t in;
+    int cfd = shard_accept_forwarded(&in);
+    if (cfd >= 0) {
+        int slot = add_client(cfd);
+        if (slot >= 0) handle_client_input(slot, &in);
+    }
+}
+
+// Prenosná slučka nad select(), vráti 1 ak server prevzal nový proces
+static int run_select_loop(int serverFd, int inboxFd, int sharded) {
+    while (!stopRequested) {
         fd_set rfds;
         FD_ZERO(&rfds);
         FD_SET(serverFd, &rfds);
-        FD_SET(STDIN_FILENO, &rfds);
         int maxfd = serverFd;
+        if (!sharded) {
+            FD_SET(STDIN_FILENO, &rfds);
+        }
+        if (inboxFd >= 0) {
+            FD_SET(inboxFd, &rfds);
+            if (inboxFd > maxfd) maxfd = inboxFd;
+        }
+        if (controlFd >= 0) {
+            FD_SET(controlFd, &rfds);
+            if (controlFd > maxfd) maxfd = controlFd;
+        }
         
         for (int i = 0; i < MAX_PLAYERS; i++) {
             if (clients[i].active) {
@@ -226,135 +1154,320 @@ int main(void) {
 
         int ready = select(maxfd + 1, &rfds, NULL, NULL, &tv);
         if (ready < 0) {
+            if (errno == EINTR) {
+                check_trace_dump();
+                continue;
+            }
             perror("select");
             break;
         }
+        refill_input_batches();
+        check_trace_dump();
+        send_pings();
+        rebalance_games();
         
         // Check if user wants to quit
-        if (FD_ISSET(STDIN_FILENO, &rfds)) {
-            char ch;
-            if (read(STDIN_FILENO, &ch, 1) > 0 && (ch == 'q' || ch == 'Q')) {
-                printf("\nShutting down server...\n");
-                break;
-            }
+        if (!sharded && FD_ISSET(STDIN_FILENO, &rfds) && handle_stdin()) {
+            break;
         }
         
+        if (controlFd >= 0 && FD_ISSET(controlFd, &rfds) && handle_control(serverFd)) {
+            return 1;
+        }
+
         if (FD_ISSET(serverFd, &rfds)) {
             int cfd = accept(serverFd, NULL, NULL);
             if (cfd >= 0) {
-                pthread_mutex_lock(&clientsMutex);
-                int slot = -1;
-                for (int i = 0; i < MAX_PLAYERS; i++) {
-                    if (!clients[i].active) {
-                        slot = i;
-                        break;
-                    }
-                }
-                if (slot >= 0) {
-                    clients[slot].fd = cfd;
-                    clients[slot].gameId = -1;
-                    clients[slot].playerIdx = -1;
-                    clients[slot].active = 1;
-                    printf("Client %d connected, waiting for action\n", slot);
-                } else {
-                    close(cfd);
-                    printf("Rejected connection, server full\n");
-                }
-                pthread_mutex_unlock(&clientsMutex);
+                accept_client(cfd);
             }
         }
+
+        if (inboxFd >= 0 && FD_ISSET(inboxFd, &rfds)) {
+            handle_inbox();
+        }
         
         for (int i = 0; i < MAX_PLAYERS; i++) {
             if (!clients[i].active) continue;
             if (FD_ISSET(clients[i].fd, &rfds)) {
-                client_input_t in;
-                ssize_t n = recv(clients[i].fd, &in, sizeof(in), 0);
-                if (n <= 0) {
+                if (read_client_inputs(i) < 0) {
                     remove_client(i);
                     printf("Client %d disconnected\n", i);
-                } else {
-                    // Ulož player_id z vstupu
-                    pthread_mutex_lock(&clientsMutex);
-                    clients[i].playerId = in.playerId;
-                    int has_game = clients[i].gameId >= 0;
-                    int oldGameId = clients[i].gameId;
-                    int oldPlayerIdx = clients[i].playerIdx;
-                    pthread_mutex_unlock(&clientsMutex);
-                    
-                    // Ak klient chce odísť zo svojej hry
-                    if (has_game && in.action == ACTION_QUIT) {
-                        pthread_mutex_lock(&gamesMutex);
-                        game_remove_player(&games[oldGameId], oldPlayerIdx, 1);  // 1 = úplné oslobodenie
-                        pthread_mutex_unlock(&gamesMutex);
-                        
-                        pthread_mutex_lock(&clientsMutex);
-                        clients[i].gameId = -1;
-                        clients[i].playerIdx = -1;
-                        pthread_mutex_unlock(&clientsMutex);
-                        
-                        printf("Client %d quit game %d\n", i, oldGameId);
-                    }
-                    // Vytvor novú hru (quit volaný pred týmto)
-                    else if (!has_game && in.action == ACTION_CREATE_GAME) {
-                        int gid = create_new_game();
-                        if (gid >= 0) {
-                            pthread_mutex_lock(&gamesMutex);
-                            int pidx = game_add_player(&games[gid], in.playerId);
-                            pthread_mutex_unlock(&gamesMutex);
-                            
-                            if (pidx >= 0) {
-                                pthread_mutex_lock(&clientsMutex);
-                                clients[i].playerId = in.playerId;
-                                clients[i].gameId = gid;
-                                clients[i].playerIdx = pidx;
-                                pthread_mutex_unlock(&clientsMutex);
-                                
-                                printf("Client %d created game %d\n", i, gid);
-                                usleep(500000);
-                                broadcast_to_game(gid);
-                            } else {
-                                printf("Player %d cannot create game (dead/full)\n", in.playerId);
-                                send(clients[i].fd, &games[gid], sizeof(game_state_t), 0);
-                            }
-                        }
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+// Udalosti hlavného ringu: typ v horných bitoch user_data, pri recv aj slot a connId
+enum {
+    EV_ACCEPT = 1,
+    EV_RECV,
+    EV_STDIN,
+    EV_CONTROL,
+    EV_INBOX,
+    EV_TIMEOUT,
+    EV_CANCEL
+};
+#define EV_DATA(type, slot, conn) (((uint64_t)(type) << 56) | ((uint64_t)(conn) << 16) | (uint64_t)(slot))
+#define EV_TYPE(data) ((int)((data) >> 56))
+#define EV_SLOT(data) ((int)((data) & 0xffffu))
+#define EV_CONN(data) ((unsigned)(((data) >> 16) & 0xffffffffu))
+
+#define URING_ENTRIES 256
+#define URING_RX_BUFFERS 64      // Mocnina dvojky
+#define URING_RX_BUFFER_SIZE 512
+
+typedef struct UringLoop {
+    uring_t ring;
+    uring_buf_ring_t rx;                 // Zdieľané recv buffre (skupina 0)
+    int serverFd;
+    int multishotAccept;                 // Vypne sa na jadrách bez podpory
+    int multishotRecv;
+    unsigned armedConn[MAX_PLAYERS];     // connId, pre ktorý beží recv v slote (0 = žiadny)
+} uring_loop_t;
+
+static struct io_uring_sqe *loop_sqe(uring_loop_t *l) {
+    struct io_uring_sqe *sqe = uring_get_sqe(&l->ring);
+    if (!sqe) {
+        // Plná SQ - odovzdaj jadru, čo už je pripravené
+        uring_submit(&l->ring, 0);
+        sqe = uring_get_sqe(&l->ring);
+    }
+    return sqe;
+}
+
+static void loop_arm_accept(uring_loop_t *l) {
+    struct io_uring_sqe *sqe = loop_sqe(l);
+    if (sqe) uring_prep_accept(sqe, l->serverFd, l->multishotAccept, EV_DATA(EV_ACCEPT, 0, 0));
+}
+
+static void loop_arm_poll(uring_loop_t *l, int fd, int type) {
+    struct io_uring_sqe *sqe = loop_sqe(l);
+    if (sqe) uring_prep_poll(sqe, fd, POLLIN, EV_DATA(type, 0, 0));
+}
+
+static void loop_arm_timeout(uring_loop_t *l) {
+    // Kontrola stopRequested aj bez prevádzky, ako timeout select()
+    static struct __kernel_timespec ts = {1, 0};
+    struct io_uring_sqe *sqe = loop_sqe(l);
+    if (sqe) uring_prep_timeout(sqe, &ts, EV_DATA(EV_TIMEOUT, 0, 0));
+}
+
+static void loop_cancel_recv(uring_loop_t *l, int i) {
+    struct io_uring_sqe *sqe = loop_sqe(l);
+    if (sqe) uring_prep_cancel(sqe, EV_DATA(EV_RECV, i, l->armedConn[i]), EV_DATA(EV_CANCEL, 0, 0));
+    l->armedConn[i] = 0;
+}
+
+// Zosúladí recv požiadavky s tabuľkou klientov: zruší ich pre odpojené/odovzdané
+// spojenia (inak by ring držal socket otvorený) a spustí pre nové
+static void loop_sync_clients(uring_loop_t *l) {
+    for (int i = 0; i < MAX_PLAYERS; i++) {
+        if (l->armedConn[i] && (!clients[i].active || clients[i].connId != l->armedConn[i])) {
+            loop_cancel_recv(l, i);
+        }
+        if (clients[i].active && !l->armedConn[i]) {
+            struct io_uring_sqe *sqe = loop_sqe(l);
+            if (!sqe) continue;
+            uring_prep_recv(sqe, clients[i].fd, l->rx.bgid, l->multishotRecv,
+                            EV_DATA(EV_RECV, i, clients[i].connId));
+            l->armedConn[i] = clients[i].connId;
+        }
+    }
+}
+
+static void loop_handle_recv(uring_loop_t *l, uint64_t data, int res, unsigned flags) {
+    int i = EV_SLOT(data);
+    unsigned conn = EV_CONN(data);
+    int current = l->armedConn[i] == conn && clients[i].active && clients[i].connId == conn;
+
+    if (flags & IORING_CQE_F_BUFFER) {
+        unsigned bid = flags >> IORING_CQE_BUFFER_SHIFT;
+        if (current && res > 0) feed_client_bytes(i, uring_buf(&l->rx, bid), res);
+        uring_buf_recycle(&l->rx, bid);
+    }
+    if (!current) return;  // Zrušené alebo staré spojenie v slote
+
+    if (res > 0 || res == -ENOBUFS || res == -ECANCELED) {
+        // Multishot recv skončil (alebo je jednorazový) - sync ho spustí znova
+        if (!(flags & IORING_CQE_F_MORE)) l->armedConn[i] = 0;
+        return;
+    }
+    if (res == -EINVAL && l->multishotRecv) {
+        l->multishotRecv = 0;  // Jadro bez multishot recv
+        l->armedConn[i] = 0;
+        return;
+    }
+    l->armedConn[i] = 0;
+    remove_client(i);
+    printf("Client %d disconnected\n", i);
+}
+
+// Slučka nad io_uring: multishot accept, multishot recv do zdieľaných bufferov,
+// poll pre stdin/riadiaci socket/inbox. Vráti 1 ak server prevzal nový proces,
+// 0 pri vypnutí a -1 ak io_uring nie je k dispozícii.
+static int run_uring_loop(int serverFd, int inboxFd, int sharded) {
+    uring_loop_t l;
+    memset(&l, 0, sizeof(l));
+    l.serverFd = serverFd;
+    l.multishotAccept = 1;
+    l.multishotRecv = 1;
+    if (uring_init(&l.ring, URING_ENTRIES) < 0) return -1;
+    if (uring_buf_ring_init(&l.ring, &l.rx, 0, URING_RX_BUFFERS, URING_RX_BUFFER_SIZE) < 0) {
+        uring_close(&l.ring);
+        return -1;
+    }
+    pthread_mutex_lock(&clientsMutex);
+    int sendOk = uring_init(&sendRing, 2 * MAX_PLAYERS) == 0;
+    pthread_mutex_unlock(&clientsMutex);
+    if (!sendOk) {
+        uring_buf_ring_free(&l.ring, &l.rx);
+        uring_close(&l.ring);
+        return -1;
+    }
+    printf("Using io_uring network backend\n");
+
+    loop_arm_accept(&l);
+    if (!sharded) loop_arm_poll(&l, STDIN_FILENO, EV_STDIN);
+    if (controlFd >= 0) loop_arm_poll(&l, controlFd, EV_CONTROL);
+    if (inboxFd >= 0) loop_arm_poll(&l, inboxFd, EV_INBOX);
+    loop_arm_timeout(&l);
+
+    int running = 1;
+    while (running && !stopRequested) {
+        loop_sync_clients(&l);
+        if (uring_submit(&l.ring, 1) < 0) {
+            if (errno == EINTR) {
+                check_trace_dump();
+                continue;
+            }
+            perror("io_uring_enter");
+            break;
+        }
+        refill_input_batches();
+        check_trace_dump();
+        send_pings();
+        rebalance_games();
+
+        struct io_uring_cqe *cqe;
+        while (running && (cqe = uring_peek_cqe(&l.ring)) != NULL) {
+            uint64_t data = cqe->user_data;
+            int res = cqe->res;
+            unsigned flags = cqe->flags;
+            uring_cqe_seen(&l.ring);
+
+            switch (EV_TYPE(data)) {
+                case EV_ACCEPT:
+                    if (res >= 0) {
+                        accept_client(res);
+                    } else if (res == -EINVAL && l.multishotAccept) {
+                        l.multishotAccept = 0;  // Jadro bez multishot accept
                     }
-                    // Pripoj sa k existujúcej hre (klient už poslal QUIT pred týmto)
-                    else if (!has_game && in.action == ACTION_JOIN_GAME) {
-                        int gid = in.gameId;
-                        pthread_mutex_lock(&gamesMutex);
-                        int can_join = (gid >= 0 && gid < MAX_PLAYERS && games[gid].gameRunning);
-                        int pidx = -1;
-                        if (can_join) {
-                            pidx = game_add_player(&games[gid], in.playerId);
-                        }
-                        pthread_mutex_unlock(&gamesMutex);
-                        
-                        if (pidx >= 0) {
-                            pthread_mutex_lock(&clientsMutex);
-                            clients[i].playerId = in.playerId;
-                            clients[i].gameId = gid;
-                            clients[i].playerIdx = pidx;
-                            pthread_mutex_unlock(&clientsMutex);
-                            printf("Client %d joined game %d\n", i, gid);
-                            usleep(500000);
-                            broadcast_to_game(gid);
-                        } else {
-                            printf("Client %d cannot join game %d (result=%d)\n", i, gid, pidx);
-                            // Pošli stav hry aby vedel, že sa nepridá
-                            if (gid >= 0 && gid < MAX_PLAYERS) {
-                                send(clients[i].fd, &games[gid], sizeof(game_state_t), 0);
-                            }
-                        }
+                    if (!(flags & IORING_CQE_F_MORE)) loop_arm_accept(&l);
+                    break;
+                case EV_RECV:
+                    loop_handle_recv(&l, data, res, flags);
+                    break;
+                case EV_STDIN:
+                    if (handle_stdin()) {
+                        running = 0;
+                    } else {
+                        loop_arm_poll(&l, STDIN_FILENO, EV_STDIN);
                     }
-                    // Iné akcie (MOVE, PAUSE) spracuj v aktívnej hre
-                    else if (has_game) {
-                        process_input_wrapper(i, &in);
+                    break;
+                case EV_CONTROL:
+                    // Nový proces musí dostať sockety, z ktorých tento ring už nečíta
+                    for (int i = 0; i < MAX_PLAYERS; i++) {
+                        if (l.armedConn[i]) loop_cancel_recv(&l, i);
                     }
-                }
+                    uring_submit(&l.ring, 0);
+                    if (handle_control(serverFd)) return 1;  // Proces končí, ring zanikne s ním
+                    loop_arm_poll(&l, controlFd, EV_CONTROL);
+                    break;
+                case EV_INBOX:
+                    handle_inbox();
+                    loop_arm_poll(&l, inboxFd, EV_INBOX);
+                    break;
+                case EV_TIMEOUT:
+                    loop_arm_timeout(&l);
+                    break;
+                default:
+                    break;
             }
         }
     }
 
+    pthread_mutex_lock(&clientsMutex);
+    uring_close(&sendRing);
+    pthread_mutex_unlock(&clientsMutex);
+    uring_buf_ring_free(&l.ring, &l.rx);
+    uring_close(&l.ring);
+    return 0;
+}
+
+// Hlavná slučka jedného procesu; pri shardingu nečíta stdin (ten patrí supervisorovi)
+static int run_worker(int takeover) {
+    int sharded = shard_count() > 1;
+    srand((unsigned int)time(NULL) ^ (unsigned int)getpid());
+    trace_thread_name("main");
+    game_set_tick_threads(tickThreads);
+    balance_init(shard_index(), shard_count());
+    stats_start();
+    
+    // Pooly sa rezervujú naraz, stránky vzniknú až pri prvej hre/spojení
+    if (pool_init(&gamePool, sizeof(game_engine_t), MAX_PLAYERS) < 0 ||
+        pool_init(&connPool, sizeof(conn_buffer_t), MAX_PLAYERS) < 0) {
+        perror("pool_init failed");
+        return 1;
+    }
+    memset(games, 0, sizeof(games));
+    
+    for (int i = 0; i < MAX_PLAYERS; i++) {
+        clients[i].fd = -1;
+        clients[i].playerId = -1;
+        clients[i].playerIdx = -1;
+        clients[i].gameId = -1;
+        clients[i].active = 0;
+    }
+
+    bucket_init(&acceptBucket, ACCEPT_RATE, ACCEPT_BURST, ratelimit_now_ms());
+    int serverFd = takeover ? restore_from_handover() : open_listener(sharded);
+    if (serverFd < 0) return 1;
+    // Záťažovú arénu vytvorí iba prvý shard
+    if (arenaBots > 0 && !takeover && shard_index() == 0) {
+        int gid = create_new_game(-1, arenaBots, 1, NULL);
+        if (gid < 0) fprintf(stderr, "Bot arena could not be created\n");
+        else printf("Bot arena: game %d with %d bots\n", gid, botGroups[gid].count);
+    }
+    int inboxFd = shard_inbox_fd();
+    if (snapshot_enabled()) {
+        controlFd = handover_listen(controlPath);
+        if (controlFd < 0) perror("handover socket failed");
+    }
+
+    if (sharded) {
+        printf("Shard %d/%d listening on port %d\n", shard_index(), shard_count(), PORT);
+    } else {
+        printf("Server listening on port %d\n", PORT);
+        printf("Press 'q' and Enter to shutdown the server, 's' for input/network stats,\n");
+        printf("'t' to toggle tracing, 'd' to dump the trace...\n");
+    }
+    
+    int handedOver = -1;
+    if (useUring) {
+        handedOver = run_uring_loop(serverFd, inboxFd, sharded);
+        if (handedOver < 0) printf("io_uring is not available, falling back to select()\n");
+    }
+    if (handedOver < 0) {
+        handedOver = run_select_loop(serverFd, inboxFd, sharded);
+    }
+    if (handedOver) {
+        // Riadiaci socket už patrí novému procesu, súbor nemazať
+        close(controlFd);
+        return 0;
+    }
+
     // Cleanup: zatvori všetky klientske sockety
     printf("Shutting down...\n");
     for (int i = 0; i < MAX_PLAYERS; i++) {
@@ -372,6 +1485,194 @@ int main(void) {
     pthread_mutex_destroy(&clientsMutex);
     
     close(serverFd);
+    if (controlFd >= 0) {
+        close(controlFd);
+        unlink(controlPath);
+    }
+    snapshot_sync();
+    snapshot_close();
+    stats_close();
+    printf("Server shutdown complete\n");
+    return 0;
+}
+
+static pid_t spawn_worker(int index) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        shard_enter(index);
+        exit(run_worker(0));
+    }
+    if (pid < 0) perror("fork failed");
+    return pid;
+}
+
+// Supervisor: spustí workery, po páde workera uvoľní jeho hry v lobby a spustí ho znova
+static int run_supervisor(int workers) {
+    pid_t pids[MAX_PLAYERS];
+    for (int w = 0; w < workers; w++) {
+        pids[w] = spawn_worker(w);
+    }
+
+    printf("Server running %d shard workers on port %d\n", workers, PORT);
+    printf("Press 'q' and Enter to shutdown the server...\n");
+
+    while (!stopRequested) {
+        fd_set rfds;
+        FD_ZERO(&rfds);
+        FD_SET(STDIN_FILENO, &rfds);
+        struct timeval tv;
+        tv.tv_sec = 1;
+        tv.tv_usec = 0;
+
+        int ready = select(STDIN_FILENO + 1, &rfds, NULL, NULL, &tv);
+        if (ready > 0 && FD_ISSET(STDIN_FILENO, &rfds)) {
+            char ch;
+            if (read(STDIN_FILENO, &ch, 1) > 0 && (ch == 'q' || ch == 'Q')) {
+                printf("\nShutting down server...\n");
+                break;
+            }
+        }
+
+        int status;
+        pid_t dead;
+        while ((dead = waitpid(-1, &status, WNOHANG)) > 0) {
+            for (int w = 0; w < workers; w++) {
+                if (pids[w] != dead) continue;
+                printf("Shard %d exited (status %d), restarting\n", w, status);
+                for (int g = 0; g < MAX_PLAYERS; g++) {
+                    if (shard_owner(g) == w) lobby_reset(g);
+                }
+                pids[w] = spawn_worker(w);
+            }
+        }
+    }
+
+    for (int w = 0; w < workers; w++) {
+        if (pids[w] > 0) kill(pids[w], SIGTERM);
+    }
+    for (int w = 0; w < workers; w++) {
+        if (pids[w] > 0) waitpid(pids[w], NULL, 0);
+    }
     printf("Server shutdown complete\n");
     return 0;
-}
\ No newline at end of file
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [-w workers] [-s snapshot [-T]] [-a WxH] [-t threads] [-u] [-r rate] [-P] [-b bots] [-B bots] [-l stats]\n", prog);
+    fprintf(stderr, "  -w N     spusti N shard procesov (1-%d), hry sa delia podľa gameId %% N\n", MAX_PLAYERS);
+    fprintf(stderr, "  -s FILE  checkpoint hier do FILE, riadiaci socket FILE.sock pre hot restart\n");
+    fprintf(stderr, "  -T       prevezmi sockety a hry od bežiaceho servera (vyžaduje -s)\n");
+    fprintf(stderr, "  -a WxH   veľkosť arény nových hier (najviac %dx%d)\n", ARENA_MAX_WIDTH, ARENA_MAX_HEIGHT);
+    fprintf(stderr, "  -t N     vlákna pre paralelný tick veľkých arén (predvolene podľa CPU)\n");
+    fprintf(stderr, "  -u       sieťový backend nad io_uring (inak alebo bez podpory jadra select)\n");
+    fprintf(stderr, "  -r N     najviac N vstupov za sekundu od klienta (predvolene %d), zvyšok sa zahodí\n", inputRate);
+    fprintf(stderr, "  -P       zapni tracing od štartu (výpis: 'd' alebo SIGUSR1 do trace-<pid>.json)\n");
+    fprintf(stderr, "  -b N     pridaj N botov do každej novej hry (odídu, keď v hre nie je živý človek)\n");
+    fprintf(stderr, "  -B N     pri štarte vytvor arénu s N botmi, ktorá beží bez klientov (profil enginu)\n");
+    fprintf(stderr, "  -l FILE  štatistiky hráčov a rebríček v FILE (prežijú reštart), inak iba v pamäti\n");
+    fprintf(stderr, "  -q N     fronta čakajúcich spojení pre listen (predvolene %d)\n", ADMISSION_BACKLOG);
+}
+
+int main(int argc, char **argv) {
+    int workers = 1;
+    const char *snapshotFile = NULL;
+    const char *statsFile = NULL;
+    int takeover = 0;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    tickThreads = cpus > 1 ? (int)cpus - 1 : 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "w:s:Ta:t:ur:Pb:B:l:q:h")) != -1) {
+        switch (opt) {
+            case 'w':
+                workers = atoi(optarg);
+                break;
+            case 's':
+                snapshotFile = optarg;
+                break;
+            case 'T':
+                takeover = 1;
+                break;
+            case 'a':
+                if (sscanf(optarg, "%dx%d", &arenaWidth, &arenaHeight) != 2) {
+                    usage(argv[0]);
+                    return 1;
+                }
+                break;
+            case 't':
+                tickThreads = atoi(optarg);
+                break;
+            case 'u':
+                useUring = 1;
+                break;
+            case 'r':
+                inputRate = atoi(optarg);
+                break;
+            case 'P':
+                trace_set_enabled(1);
+                break;
+            case 'b':
+                botsPerGame = atoi(optarg);
+                break;
+            case 'B':
+                arenaBots = atoi(optarg);
+                break;
+            case 'l':
+                statsFile = optarg;
+                break;
+            case 'q':
+                listenBacklog = atoi(optarg);
+                break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+    if (workers < 1 || workers > MAX_PLAYERS || (takeover && !snapshotFile) || inputRate < 1 || listenBacklog < 1 ||
+        botsPerGame < 0 || arenaBots < 0 ||
+        arenaWidth < 3 || arenaWidth > ARENA_MAX_WIDTH ||
+        arenaHeight < 1 || arenaHeight > ARENA_MAX_HEIGHT) {
+        usage(argv[0]);
+        return 1;
+    }
+    // Kapacita hadíkov rastie s plochou arény, klasická aréna má MAX_PLAYERS
+    arenaSnakes = arenaWidth * arenaHeight / 80;
+    if (arenaSnakes < MAX_PLAYERS) arenaSnakes = MAX_PLAYERS;
+    if (arenaSnakes > ARENA_MAX_SNAKES) arenaSnakes = ARENA_MAX_SNAKES;
+    // Boty v hre klienta mu musia nechať voľný slot
+    if (botsPerGame > arenaSnakes - 1) botsPerGame = arenaSnakes - 1;
+    // Hot restart prenáša jednu tabuľku klientov, sharding zatiaľ nepodporuje
+    if (snapshotFile && workers > 1) {
+        fprintf(stderr, "Snapshot/hot restart is supported only with a single worker\n");
+        return 1;
+    }
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handle_stop_signal;
+    sigaction(SIGTERM, &sa, NULL);
+    sigaction(SIGINT, &sa, NULL);
+    sa.sa_handler = handle_trace_signal;
+    sigaction(SIGUSR1, &sa, NULL);
+
+    if (lobby_init() < 0 || shard_setup(workers) < 0) {
+        perror("server setup failed");
+        return 1;
+    }
+    if (stats_open(statsFile) < 0) {
+        perror("stats open failed");
+        return 1;
+    }
+
+    if (snapshotFile) {
+        snprintf(controlPath, sizeof(controlPath), "%s.sock", snapshotFile);
+        if (snapshot_open(snapshotFile) < 0) {
+            perror("snapshot open failed");
+            return 1;
+        }
+    }
+
+    if (workers == 1) {
+        return run_worker(takeover);
+    }
+    return run_supervisor(workers);
+}
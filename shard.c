@@ -0,0 +1,64 @@
+#include "shard.h"
+#include "net.h"
+#include <sys/socket.h>
+#include <unistd.h>
+
+static int shardCount = 1;
+static int shardIndex = 0;
+// inbox[i][0] číta shard i, do inbox[i][1] zapisujú ostatné
+static int inbox[MAX_PLAYERS][2];
+
+int shard_setup(int count) {
+    if (count < 1 || count > MAX_PLAYERS) return -1;
+    shardCount = count;
+    shardIndex = 0;
+    if (count == 1) return 0;
+
+    for (int i = 0; i < count; i++) {
+        if (socketpair(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0, inbox[i]) < 0) {
+            while (--i >= 0) {
+                close(inbox[i][0]);
+                close(inbox[i][1]);
+            }
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void shard_enter(int index) {
+    shardIndex = index;
+}
+
+int shard_count(void) {
+    return shardCount;
+}
+
+int shard_index(void) {
+    return shardIndex;
+}
+
+int shard_owner(int gameId) {
+    if (gameId < 0) return -1;
+    return gameId % shardCount;
+}
+
+int shard_owns(int gameId) {
+    return shard_owner(gameId) == shardIndex;
+}
+
+int shard_inbox_fd(void) {
+    return shardCount > 1 ? inbox[shardIndex][0] : -1;
+}
+
+int shard_forward_client(int clientFd, const client_input_t *input) {
+    int owner = shard_owner(input->gameId);
+    if (shardCount == 1 || owner < 0 || owner == shardIndex) return -1;
+    return net_send_fds(inbox[owner][1], &clientFd, 1, input, sizeof(*input));
+}
+
+int shard_accept_forwarded(client_input_t *input) {
+    int fd = -1;
+    int count = net_recv_fds(shard_inbox_fd(), &fd, 1, input, sizeof(*input));
+    return count == 1 ? fd : -1;
+}
@@ -0,0 +1,38 @@
+#ifndef SHARD_H
+#define SHARD_H
+
+#include "shared.h"
+
+// Sharding hier medzi worker procesy. Hra gameId patrí shardu gameId % count.
+// Každý shard má vlastný datagramový Unix socket, cez ktorý mu ostatné
+// shardy odovzdajú klienta (deskriptor + čakajúci vstup) pre jeho hru.
+
+// Pripraví kanály pre count shardov (volať pred fork), vráti 0 alebo -1
+int shard_setup(int count);
+
+// Nastaví index shardu v aktuálnom worker procese
+void shard_enter(int index);
+
+// Počet shardov (1 = bez shardingu)
+int shard_count(void);
+
+// Index aktuálneho shardu (0 bez shardingu)
+int shard_index(void);
+
+// Ktorý shard vlastní danú hru
+int shard_owner(int gameId);
+
+// 1 ak hru vlastní aktuálny proces
+int shard_owns(int gameId);
+
+// Deskriptor, na ktorom tento shard prijíma odovzdaných klientov, alebo -1
+int shard_inbox_fd(void);
+
+// Odovzdá klienta shardu, ktorý vlastní input->gameId, vráti 0 alebo -1.
+// Volajúci si po úspechu zatvorí vlastnú kópiu deskriptora.
+int shard_forward_client(int clientFd, const client_input_t *input);
+
+// Prijme odovzdaného klienta, vráti jeho deskriptor alebo -1
+int shard_accept_forwarded(client_input_t *input);
+
+#endif // SHARD_H
@@ -4,6 +4,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 
 #define PORT 12345
 #define MAX_PLAYERS 10
@@ -12,6 +13,14 @@
 #define WORLD_HEIGHT 20
 #define GAME_LOOP_MS 500
 
+// Výrez sveta, ktorý klient dostáva a vykresľuje (centrovaný na hlavu hráča)
+#define VIEW_WIDTH 40
+#define VIEW_HEIGHT 20
+#define VIEW_MARGIN 4          // Posielajú sa aj hadíky tesne za okrajom výrezu
+#define VIEW_MAX_SNAKES 32     // Najviac hadíkov v jednom výreze
+#define VIEW_MAX_EVENTS 32     // Najviac enter/leave udalostí v jednom výreze
+#define VIEW_MAX_BYTES 16384   // Horná hranica veľkosti správy s výrezom
+
 // Smer pohybu
 typedef enum Direction {
     DIR_UP,
@@ -27,39 +36,153 @@ typedef enum Action {
     ACTION_JOIN_GAME,   // Pripoj sa k existujúcej hre
     ACTION_MOVE,        // Zmena smeru
     ACTION_PAUSE,       // Pauza
-    ACTION_QUIT         // Ukončenie
+    ACTION_QUIT,        // Ukončenie
+    ACTION_LIST_GAMES,  // Zoznam bežiacich hier (lobby)
+    ACTION_PONG,        // Odpoveď na MSG_PING (stamp = pečiatka z pingu)
+    ACTION_QUICK_JOIN,  // Server vyberie hru (voľné miesta, cena ticku, ping) alebo založí novú
+    ACTION_LEADERBOARD  // Rebríček hráčov (odpoveď MSG_LEADERBOARD)
 } action_t;
 
+// Typ správy (Server → Client)
+typedef enum MessageType {
+    MSG_VIEW,           // payload: výrez sveta (view_header_t + telá, ovocie, udalosti)
+    MSG_GAME_LIST,      // payload: game_list_t (iba prvých count položiek)
+    MSG_PING,           // payload: ping_t, klient hneď odpovie ACTION_PONG
+    MSG_LEADERBOARD,    // payload: leaderboard_t (iba prvých count položiek top)
+    MSG_BUSY            // payload: busy_t, server spojenie neprijal a zatvorí ho
+} msg_type_t;
+
+// Hlavička každej správy zo servera
+typedef struct MsgHeader {
+    int type;           // msg_type_t
+    int length;         // Dĺžka payloadu v bajtoch
+} msg_header_t;
+
 // Pozícia
 typedef struct Position {
     int x;
     int y;
 } position_t;
 
-// Hadík
-typedef struct Snake {
-    int playerId;
-    position_t body[MAX_SNAKE_LENGTH];
-    int length;
-    direction_t direction;
-    int score;
-    int alive;
-    int paused;
-} snake_t;
-
-// Stav hry (Server → Client)
-typedef struct GameState {
-    int gameId;                // ID hry
-    int elapsedTime;           // Čas od začiatku v sekundách
-    snake_t snakes[MAX_PLAYERS];
+// Kódovanie hadíkov vo výreze; server pri každom výreze zvolí najkratšie
+typedef enum ViewEncoding {
+    VIEW_ENC_LIST,      // Zoznam článkov každého hadíka
+    VIEW_ENC_BITMAP,    // Tabuľka hláv + bitmapa obsadených políčok oblasti
+    VIEW_ENC_RLE,       // Tabuľka hláv + behy voľných a obsadených políčok oblasti
+    VIEW_ENC_COUNT
+} view_encoding_t;
+
+// Hlavička výrezu (Server → Client, MSG_VIEW). Za ňou nasleduje:
+//   snakeCount x view_snake_t, každý s cellCount x view_cell_t (pri LIST všetky
+//     články vo výreze, pri BITMAP a RLE iba hlava: cellCount je 0 alebo 1)
+//   BITMAP: (oblasť + 7) / 8 bajtov, bit i (od najnižšieho) = políčko i je telo
+//   RLE: uint8_t dĺžky behov striedavo voľných a obsadených políčok, začína sa
+//     voľným; dlhší beh pokračuje po 255 nulovým behom druhého druhu
+//   foodCount x view_cell_t
+//   enterCount + leaveCount x int16_t (sloty hadíkov, ktoré vošli/odišli z výhľadu)
+// Oblasť je výrez s okrajom, (viewWidth + 2 * marginX) x (viewHeight + 2 * marginY)
+// políčok po riadkoch, začína na [-marginX, -marginY] relatívne k rohu výrezu.
+typedef struct ViewHeader {
+    int gameId;
+    int elapsedTime;
     int playerCount;
-    
-    // Ovocie
-    position_t food[MAX_PLAYERS];
-    int foodCount;
-    
     int gameRunning;
-} game_state_t;
+    int worldWidth;
+    int worldHeight;
+    int originX;        // Ľavý horný roh výrezu vo svete
+    int originY;
+    int viewWidth;      // min(VIEW_WIDTH, worldWidth)
+    int viewHeight;
+    int selfSlot;       // Slot tohto hráča, -1 ak nehrá
+    int snakeCount;
+    int foodCount;
+    int enterCount;
+    int leaveCount;
+    uint32_t tickStampUs; // Kedy prebehol tick (hodiny servera, net_clock_us)
+    uint8_t encoding;   // view_encoding_t
+    int8_t marginX;     // Okraj oblasti okolo výrezu (0 ak je výrez celý svet)
+    int8_t marginY;
+    uint8_t reserved;
+} view_header_t;
+
+#define VIEW_SNAKE_ALIVE 0x01
+#define VIEW_SNAKE_PAUSED 0x02
+#define VIEW_SNAKE_HEAD 0x04   // Prvá bunka je hlava
+
+typedef struct ViewSnake {
+    int16_t slot;
+    uint8_t flags;
+    uint8_t reserved;
+    int score;
+    int cellCount;
+} view_snake_t;
+
+// Pozícia relatívne k rohu výrezu (môže byť aj v okraji VIEW_MARGIN mimo výrezu)
+typedef struct ViewCell {
+    int8_t x;
+    int8_t y;
+} view_cell_t;
+
+// Súhrn jednej hry pre lobby
+typedef struct GameSummary {
+    int gameId;
+    int playerCount;
+    int freeSlots;
+    int elapsedTime;
+    int topScore;
+    int tickCostUs;     // Vyhladená cena ticku na serveri (µs)
+    int avgRttUs;       // Priemerná RTT hráčov, 0 = nemeraná
+} game_summary_t;
+
+// Zoznam bežiacich hier (Server → Client), posiela sa iba count položiek
+typedef struct GameList {
+    int count;
+    game_summary_t games[MAX_PLAYERS];
+} game_list_t;
+
+// Meranie spojenia (Server → Client, MSG_PING). Server ho posiela raz za
+// PING_INTERVAL_MS a pribalí poslednú nameranú RTT a frontu pre overlay klienta.
+#define PING_INTERVAL_MS 1000
+
+typedef struct Ping {
+    uint32_t stamp;        // Hodiny servera pri odoslaní (net_clock_us)
+    int rttUs;             // Vyhladená RTT klienta, 0 = zatiaľ nemeraná
+    int jitterUs;          // Priemerná odchýlka RTT
+    int sendQueue;         // Neodoslané bajty v sockete klienta na serveri
+} ping_t;
+
+// Odmietnuté spojenie (Server → Client, MSG_BUSY ihneď po accept). Prijaté
+// spojenie naopak hneď dostane MSG_PING, klient tak vie, že bol prijatý.
+typedef enum BusyReason {
+    BUSY_FULL,             // Plná tabuľka klientov
+    BUSY_OVERLOAD,         // Ticky hier meškajú alebo sa hromadia neodoslané dáta
+    BUSY_RATE,             // Priveľa nových spojení naraz
+    BUSY_REASON_COUNT
+} busy_reason_t;
+
+typedef struct Busy {
+    int reason;            // busy_reason_t
+    int retryAfterMs;      // Skúsiť znova najskôr po tomto čase
+} busy_t;
+
+// Štatistiky hráča naprieč všetkými hrami servera
+#define LEADERBOARD_SIZE 10
+
+typedef struct PlayerStats {
+    int playerId;
+    int highScore;
+    int gamesPlayed;       // Ukončené účasti v hrách (smrť alebo odchod)
+    int foodEaten;
+    int survivalSec;       // Celkový čas prežitý v hrách
+} player_stats_t;
+
+// Rebríček (Server → Client), posiela sa iba count položiek top
+typedef struct Leaderboard {
+    int rank;              // Poradie žiadateľa podľa najvyššieho skóre, 0 = ešte nehral
+    player_stats_t self;
+    int count;
+    player_stats_t top[LEADERBOARD_SIZE];
+} leaderboard_t;
 
 // Vstup od klienta (Client → Server)
 typedef struct ClientInput {
@@ -67,6 +190,7 @@ typedef struct ClientInput {
     int gameId;            // Ktorej hre patrí tento vstup
     action_t action;
     direction_t direction;  // Pre ACTION_MOVE
+    uint32_t stamp;        // Pre ACTION_PONG
 } client_input_t;
 
 #endif
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "snapshot.h"
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define SNAPSHOT_MAGIC 0x48414431u  // "HAD1"
+#define SNAPSHOT_VERSION 4
+
+typedef struct SnapshotEntry {
+    int used;
+    int elapsedMs;
+    game_engine_t state;
+} snapshot_entry_t;
+
+typedef struct SnapshotFile {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entrySize;  // Iná binárka s inou veľkosťou stavu snapshot nepoužije
+    uint32_t gameCount;
+    snapshot_entry_t games[MAX_PLAYERS];
+} snapshot_file_t;
+
+static snapshot_file_t *file;
+
+int snapshot_open(const char *path) {
+    int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (st.st_size != sizeof(snapshot_file_t) &&
+                               ftruncate(fd, sizeof(snapshot_file_t)) < 0)) {
+        close(fd);
+        return -1;
+    }
+
+    void *mem = mmap(NULL, sizeof(snapshot_file_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED) return -1;
+    file = mem;
+
+    // Neznámy alebo nekompatibilný obsah zahodíme
+    if (file->magic != SNAPSHOT_MAGIC || file->version != SNAPSHOT_VERSION ||
+        file->entrySize != sizeof(snapshot_entry_t) || file->gameCount != MAX_PLAYERS) {
+        memset(file, 0, sizeof(*file));
+        file->magic = SNAPSHOT_MAGIC;
+        file->version = SNAPSHOT_VERSION;
+        file->entrySize = sizeof(snapshot_entry_t);
+        file->gameCount = MAX_PLAYERS;
+    }
+    return 0;
+}
+
+int snapshot_enabled(void) {
+    return file != NULL;
+}
+
+void snapshot_store(int gameId, const game_engine_t *state, int elapsedMs) {
+    if (!file || gameId < 0 || gameId >= MAX_PLAYERS) return;
+    snapshot_entry_t *e = &file->games[gameId];
+    game_copy(&e->state, state);
+    e->elapsedMs = elapsedMs;
+    e->used = 1;
+}
+
+void snapshot_clear(int gameId) {
+    if (!file || gameId < 0 || gameId >= MAX_PLAYERS) return;
+    file->games[gameId].used = 0;
+}
+
+int snapshot_load(int gameId, game_engine_t *state, int *elapsedMs) {
+    if (!file || gameId < 0 || gameId >= MAX_PLAYERS) return 0;
+    const snapshot_entry_t *e = &file->games[gameId];
+    if (!e->used || !e->state.gameRunning) return 0;
+    game_copy(state, &e->state);
+    game_rebuild_cells(state);
+    *elapsedMs = e->elapsedMs;
+    return 1;
+}
+
+void snapshot_sync(void) {
+    if (file) msync(file, sizeof(*file), MS_SYNC);
+}
+
+void snapshot_close(void) {
+    if (!file) return;
+    munmap(file, sizeof(*file));
+    file = NULL;
+}
@@ -0,0 +1,30 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "shared.h"
+#include "game.h"
+
+// Checkpoint všetkých hier v súbore namapovanom cez mmap.
+// Herné vlákna doň zapisujú po každom ticku, nový proces ho po reštarte načíta.
+
+// Namapuje (alebo vytvorí) súbor so snapshotom, vráti 0 alebo -1
+int snapshot_open(const char *path);
+
+// 1 ak je snapshot otvorený
+int snapshot_enabled(void);
+
+// Uloží stav hry do jej slotu (volať pod zámkom hry)
+void snapshot_store(int gameId, const game_engine_t *state, int elapsedMs);
+
+// Označí slot hry ako prázdny (hra skončila)
+void snapshot_clear(int gameId);
+
+// Načíta hru zo slotu, vráti 1 ak slot obsahuje bežiacu hru
+int snapshot_load(int gameId, game_engine_t *state, int *elapsedMs);
+
+// Vynúti zápis namapovaných stránok na disk
+void snapshot_sync(void);
+
+void snapshot_close(void);
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,268 @@
+#include "stats.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define STATS_MAGIC 0x48535431u  // "HST1"
+#define STATS_VERSION 1
+#define STATS_RING_SIZE 256      // Mocnina dvojky
+#define STATS_FOOD_SCORE 10      // Body za jedno ovocie v game_tick
+
+typedef struct StatsEntry {
+    atomic_int playerId;         // 0 = voľné; obsadí sa CAS-om a už sa neuvoľní
+    atomic_int highScore;
+    atomic_int gamesPlayed;
+    atomic_int foodEaten;
+    atomic_llong survivalMs;
+} stats_entry_t;
+
+typedef struct StatsFile {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entrySize;
+    uint32_t capacity;
+    atomic_int players;
+    stats_entry_t entries[STATS_MAX_PLAYERS];
+} stats_file_t;
+
+// Jedna ukončená účasť hráča v hre
+typedef struct StatsRecord {
+    int playerId;
+    int score;
+    int survivalMs;
+} stats_record_t;
+
+// Buffer jednej hry: zapisuje iba jej herné vlákno, číta iba zlučovacie vlákno
+typedef struct StatsRing {
+    atomic_uint head;
+    char pad[60];                // head a tail na rôznych cache lines
+    atomic_uint tail;
+    stats_record_t records[STATS_RING_SIZE];
+} stats_ring_t;
+
+// Účasť sledovaná herným vláknom (slot hry)
+typedef struct StatsTracked {
+    int active;
+    int playerId;
+    int startMs;
+    int score;
+} stats_tracked_t;
+
+static stats_file_t *file;
+static int fileBacked = 0;
+static stats_ring_t rings[MAX_PLAYERS];
+static stats_tracked_t tracked[MAX_PLAYERS][ARENA_MAX_SNAKES];
+static atomic_long dropped;
+static pthread_t mergeThread;
+static int mergeStarted = 0;
+static atomic_int stopMerge;
+
+int stats_open(const char *path) {
+    void *mem;
+    if (path) {
+        int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) return -1;
+        struct stat st;
+        if (fstat(fd, &st) < 0 || (st.st_size != sizeof(stats_file_t) &&
+                                   ftruncate(fd, sizeof(stats_file_t)) < 0)) {
+            close(fd);
+            return -1;
+        }
+        mem = mmap(NULL, sizeof(stats_file_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+    } else {
+        mem = mmap(NULL, sizeof(stats_file_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    }
+    if (mem == MAP_FAILED) return -1;
+    file = mem;
+    fileBacked = path != NULL;
+
+    // Neznámy alebo nekompatibilný obsah zahodíme
+    if (file->magic != STATS_MAGIC || file->version != STATS_VERSION ||
+        file->entrySize != sizeof(stats_entry_t) || file->capacity != STATS_MAX_PLAYERS) {
+        memset(file, 0, sizeof(*file));
+        file->magic = STATS_MAGIC;
+        file->version = STATS_VERSION;
+        file->entrySize = sizeof(stats_entry_t);
+        file->capacity = STATS_MAX_PLAYERS;
+    }
+    return 0;
+}
+
+// Nájde riadok hráča, pri create ho obsadí; NULL ak nie je / tabuľka je plná
+static stats_entry_t *find_entry(int playerId, int create) {
+    unsigned h = ((unsigned)playerId * 2654435761u) % STATS_MAX_PLAYERS;
+    for (int probe = 0; probe < STATS_MAX_PLAYERS; probe++) {
+        stats_entry_t *e = &file->entries[(h + (unsigned)probe) % STATS_MAX_PLAYERS];
+        int id = atomic_load_explicit(&e->playerId, memory_order_acquire);
+        if (id == playerId) return e;
+        if (id != 0) continue;
+        if (!create) return NULL;
+        // Iný shard mohol riadok práve obsadiť, pre iného alebo toho istého hráča
+        int expected = 0;
+        if (atomic_compare_exchange_strong(&e->playerId, &expected, playerId)) {
+            atomic_fetch_add_explicit(&file->players, 1, memory_order_relaxed);
+            return e;
+        }
+        if (expected == playerId) return e;
+    }
+    return NULL;
+}
+
+static void merge_record(const stats_record_t *r) {
+    stats_entry_t *e = find_entry(r->playerId, 1);
+    if (!e) {
+        atomic_fetch_add_explicit(&dropped, 1, memory_order_relaxed);
+        return;
+    }
+    atomic_fetch_add_explicit(&e->gamesPlayed, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&e->foodEaten, r->score / STATS_FOOD_SCORE, memory_order_relaxed);
+    atomic_fetch_add_explicit(&e->survivalMs, r->survivalMs, memory_order_relaxed);
+    int best = atomic_load_explicit(&e->highScore, memory_order_relaxed);
+    while (r->score > best &&
+           !atomic_compare_exchange_weak(&e->highScore, &best, r->score)) {
+    }
+}
+
+static void merge_rings(void) {
+    for (int g = 0; g < MAX_PLAYERS; g++) {
+        stats_ring_t *ring = &rings[g];
+        unsigned tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        unsigned head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        while (tail != head) {
+            merge_record(&ring->records[tail % STATS_RING_SIZE]);
+            tail++;
+        }
+        atomic_store_explicit(&ring->tail, tail, memory_order_release);
+    }
+}
+
+static void *merge_main(void *arg) {
+    (void)arg;
+    while (!atomic_load(&stopMerge)) {
+        usleep(STATS_MERGE_MS * 1000);
+        merge_rings();
+    }
+    return NULL;
+}
+
+int stats_start(void) {
+    if (!file || mergeStarted) return 0;
+    atomic_store(&stopMerge, 0);
+    if (pthread_create(&mergeThread, NULL, merge_main, NULL) != 0) {
+        perror("stats merge thread");
+        return -1;
+    }
+    mergeStarted = 1;
+    return 0;
+}
+
+static void push_record(int gameId, const stats_tracked_t *t, int elapsedMs) {
+    stats_ring_t *ring = &rings[gameId];
+    unsigned head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head - tail >= STATS_RING_SIZE) {
+        atomic_fetch_add_explicit(&dropped, 1, memory_order_relaxed);
+        return;
+    }
+    stats_record_t *r = &ring->records[head % STATS_RING_SIZE];
+    r->playerId = t->playerId;
+    r->score = t->score;
+    r->survivalMs = elapsedMs - t->startMs;
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+void stats_track(int gameId, const game_engine_t *state, int elapsedMs) {
+    if (!file || gameId < 0 || gameId >= MAX_PLAYERS) return;
+    for (int i = 0; i < state->maxSnakes; i++) {
+        stats_tracked_t *t = &tracked[gameId][i];
+        int id = state->playerId[i];
+        int alive = game_player_alive(state, i);
+        if (t->active) {
+            // Skóre sa po trvalom odstránení nuluje, platí posledné videné
+            if (id == t->playerId) t->score = state->score[i];
+            if (!alive || id != t->playerId) {
+                push_record(gameId, t, elapsedMs);
+                t->active = 0;
+            }
+        }
+        // Boty (záporné ID) sa do rebríčka nepočítajú
+        if (!t->active && alive && id > 0) {
+            t->active = 1;
+            t->playerId = id;
+            t->startMs = elapsedMs;
+            t->score = state->score[i];
+        }
+    }
+}
+
+void stats_game_over(int gameId, int elapsedMs) {
+    if (!file || gameId < 0 || gameId >= MAX_PLAYERS) return;
+    for (int i = 0; i < ARENA_MAX_SNAKES; i++) {
+        stats_tracked_t *t = &tracked[gameId][i];
+        if (t->active) push_record(gameId, t, elapsedMs);
+        t->active = 0;
+    }
+}
+
+static void load_entry(const stats_entry_t *e, player_stats_t *out) {
+    out->playerId = atomic_load_explicit(&e->playerId, memory_order_acquire);
+    out->highScore = atomic_load_explicit(&e->highScore, memory_order_relaxed);
+    out->gamesPlayed = atomic_load_explicit(&e->gamesPlayed, memory_order_relaxed);
+    out->foodEaten = atomic_load_explicit(&e->foodEaten, memory_order_relaxed);
+    out->survivalSec = (int)(atomic_load_explicit(&e->survivalMs, memory_order_relaxed) / 1000);
+}
+
+static int ranks_before(const player_stats_t *a, const player_stats_t *b) {
+    if (a->highScore != b->highScore) return a->highScore > b->highScore;
+    return a->playerId < b->playerId;
+}
+
+void stats_leaderboard(int playerId, leaderboard_t *out) {
+    memset(out, 0, sizeof(*out));
+    if (!file) return;
+
+    const stats_entry_t *self = playerId > 0 ? find_entry(playerId, 0) : NULL;
+    if (self) load_entry(self, &out->self);
+    int better = 0;
+    for (int k = 0; k < STATS_MAX_PLAYERS; k++) {
+        player_stats_t p;
+        load_entry(&file->entries[k], &p);
+        if (p.playerId == 0) continue;
+        if (self && p.highScore > out->self.highScore) better++;
+
+        // Vloženie do zoradenej desiatky
+        int pos = out->count;
+        while (pos > 0 && ranks_before(&p, &out->top[pos - 1])) pos--;
+        if (pos >= LEADERBOARD_SIZE) continue;
+        int last = out->count < LEADERBOARD_SIZE ? out->count : LEADERBOARD_SIZE - 1;
+        memmove(&out->top[pos + 1], &out->top[pos], (size_t)(last - pos) * sizeof(out->top[0]));
+        out->top[pos] = p;
+        if (out->count < LEADERBOARD_SIZE) out->count++;
+    }
+    out->rank = self ? better + 1 : 0;
+}
+
+int stats_player_count(void) {
+    return file ? atomic_load_explicit(&file->players, memory_order_relaxed) : 0;
+}
+
+long stats_dropped(void) {
+    return atomic_load_explicit(&dropped, memory_order_relaxed);
+}
+
+void stats_close(void) {
+    if (!file) return;
+    if (mergeStarted) {
+        atomic_store(&stopMerge, 1);
+        pthread_join(mergeThread, NULL);
+        mergeStarted = 0;
+    }
+    merge_rings();
+    if (fileBacked) msync(file, sizeof(*file), MS_SYNC);
+    munmap(file, sizeof(*file));
+    file = NULL;
+}
@@ -0,0 +1,42 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include "shared.h"
+#include "game.h"
+
+// Štatistiky hráčov naprieč hrami (rebríček).
+// Herné vlákno po ticku iba porovná sloty so svojím sledovaním a ukončené
+// účasti zapíše do vlastného kruhového buffera bez zámkov (plný buffer
+// záznam zahodí, tick nikdy nečaká). Vlákno na pozadí ich raz za
+// STATS_MERGE_MS zlúči do tabuľky hráčov v zdieľanej pamäti, ktorú vidia
+// všetky shardy; tabuľka sa mení iba atomickými operáciami a pri -l leží
+// v súbore namapovanom cez mmap, takže prežije reštart.
+
+#define STATS_MAX_PLAYERS 4096
+#define STATS_MERGE_MS 500
+
+// Namapuje tabuľku (path NULL = iba v pamäti), volať pred fork, vráti 0 alebo -1
+int stats_open(const char *path);
+
+// Spustí zlučovacie vlákno (v každom procese zvlášť, po fork), vráti 0 alebo -1
+int stats_start(void);
+
+// Po ticku (iba herné vlákno hry, pod zámkom hry): ukončené účasti pôjdu do buffera
+void stats_track(int gameId, const game_engine_t *state, int elapsedMs);
+
+// Hra skončila: ukončí všetky účasti, ktoré ešte sledovala
+void stats_game_over(int gameId, int elapsedMs);
+
+// Najlepší hráči podľa najvyššieho skóre a riadok žiadateľa
+void stats_leaderboard(int playerId, leaderboard_t *out);
+
+// Počet hráčov v tabuľke
+int stats_player_count(void);
+
+// Záznamy zahodené pre plný buffer alebo plnú tabuľku
+long stats_dropped(void);
+
+// Zastaví zlučovacie vlákno, zlúči zvyšok a zapíše tabuľku na disk
+void stats_close(void);
+
+#endif // STATS_H
@@ -0,0 +1,129 @@
+#include "trace.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#define TRACE_MAX_THREADS 64
+#define TRACE_RING_EVENTS 4096    // Mocnina dvojky, staršie udalosti sa prepíšu
+#define TRACE_NAME_LEN 32
+
+typedef struct TraceEvent {
+    const char *name;
+    int64_t startNs;
+    int64_t durNs;
+} trace_event_t;
+
+// Buffer jedného vlákna; zapisuje iba vlastník, výpis číta bez zámku
+typedef struct TraceRing {
+    atomic_uint_fast64_t head;   // Počet zapísaných udalostí
+    atomic_int owned;            // Buffer patrí živému vláknu
+    int tid;
+    char threadName[TRACE_NAME_LEN];
+    trace_event_t events[TRACE_RING_EVENTS];
+} trace_ring_t;
+
+atomic_int traceActive = 0;
+
+static trace_ring_t rings[TRACE_MAX_THREADS];
+static atomic_int ringCount = 0;        // Najvyšší použitý index + 1
+static _Thread_local trace_ring_t *threadRing;
+static _Thread_local int threadNoRing;  // Všetky buffre sú obsadené
+static pthread_key_t ringKey;
+static pthread_once_t ringKeyOnce = PTHREAD_ONCE_INIT;
+
+// Ukončené vlákno (napr. herné) uvoľní buffer pre ďalšie vlákno
+static void release_ring(void *arg) {
+    trace_ring_t *ring = arg;
+    atomic_store(&ring->owned, 0);
+}
+
+static void create_ring_key(void) {
+    pthread_key_create(&ringKey, release_ring);
+}
+
+int64_t trace_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// Buffer vlákna vzniká pri prvom úseku, ktorý vlákno zaznamená
+static trace_ring_t *thread_ring(void) {
+    if (threadRing || threadNoRing) return threadRing;
+    pthread_once(&ringKeyOnce, create_ring_key);
+    for (int idx = 0; idx < TRACE_MAX_THREADS; idx++) {
+        int expected = 0;
+        if (!atomic_compare_exchange_strong(&rings[idx].owned, &expected, 1)) continue;
+
+        trace_ring_t *ring = &rings[idx];
+        // Udalosti predchádzajúceho vlastníka by sa pripísali novému vláknu
+        atomic_store(&ring->head, 0);
+        ring->tid = (int)syscall(SYS_gettid);
+        snprintf(ring->threadName, sizeof(ring->threadName), "thread %d", ring->tid);
+        int count = atomic_load(&ringCount);
+        while (count < idx + 1 && !atomic_compare_exchange_weak(&ringCount, &count, idx + 1)) {
+        }
+        pthread_setspecific(ringKey, ring);
+        threadRing = ring;
+        return ring;
+    }
+    threadNoRing = 1;
+    return NULL;
+}
+
+void trace_record(const char *name, int64_t startNs, int64_t endNs) {
+    trace_ring_t *ring = thread_ring();
+    if (!ring) return;
+    uint_fast64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    trace_event_t *ev = &ring->events[head & (TRACE_RING_EVENTS - 1)];
+    ev->name = name;
+    ev->startNs = startNs;
+    ev->durNs = endNs - startNs;
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+void trace_set_enabled(int enabled) {
+    atomic_store(&traceActive, enabled ? 1 : 0);
+}
+
+int trace_enabled(void) {
+    return atomic_load(&traceActive);
+}
+
+void trace_thread_name(const char *name) {
+    trace_ring_t *ring = thread_ring();
+    if (ring) snprintf(ring->threadName, sizeof(ring->threadName), "%s", name);
+}
+
+int trace_dump(const char *path) {
+    FILE *f = fopen(path, "w");
+    if (!f) return -1;
+
+    int pid = (int)getpid();
+    int count = atomic_load(&ringCount);
+    if (count > TRACE_MAX_THREADS) count = TRACE_MAX_THREADS;
+    int events = 0;
+    fprintf(f, "{\"traceEvents\":[\n");
+    for (int r = 0; r < count; r++) {
+        trace_ring_t *ring = &rings[r];
+        fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                r ? ",\n" : "", pid, ring->tid, ring->threadName);
+
+        // Zapisovateľ môže medzitým prepísať najstaršie udalosti; pri profilovaní to nevadí
+        uint_fast64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        uint_fast64_t first = head > TRACE_RING_EVENTS ? head - TRACE_RING_EVENTS : 0;
+        for (uint_fast64_t i = first; i < head; i++) {
+            const trace_event_t *ev = &ring->events[i & (TRACE_RING_EVENTS - 1)];
+            if (!ev->name) continue;
+            fprintf(f, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                    ev->name, pid, ring->tid, ev->startNs / 1000.0, ev->durNs / 1000.0);
+            events++;
+        }
+    }
+    fprintf(f, "\n],\"displayTimeUnit\":\"ns\"}\n");
+    fclose(f);
+    return events;
+}
@@ -0,0 +1,40 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+
+// Merania úsekov (spans) do kruhových bufferov jednotlivých vlákien, výpis
+// v Chrome trace-event JSON (chrome://tracing, Perfetto). Vypnuté stojí
+// jeden relaxed load a vetvenie na začiatku úseku:
+//
+//     int64_t t0 = trace_begin();
+//     ... meraný úsek ...
+//     trace_end("tick.compute", t0);
+//
+// Názov musí byť reťazcový literál (ukladá sa iba ukazovateľ).
+
+extern atomic_int traceActive;
+
+int64_t trace_now_ns(void);
+void trace_record(const char *name, int64_t startNs, int64_t endNs);
+
+static inline int64_t trace_begin(void) {
+    if (!atomic_load_explicit(&traceActive, memory_order_relaxed)) return 0;
+    return trace_now_ns();
+}
+
+static inline void trace_end(const char *name, int64_t startNs) {
+    if (startNs) trace_record(name, startNs, trace_now_ns());
+}
+
+void trace_set_enabled(int enabled);
+int trace_enabled(void);
+
+// Pomenuje volajúce vlákno vo výstupe
+void trace_thread_name(const char *name);
+
+// Zapíše obsah všetkých bufferov do súboru, vráti počet udalostí alebo -1
+int trace_dump(const char *path);
+
+#endif // TRACE_H
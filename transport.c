@@ -0,0 +1,83 @@
+#include "transport.h"
+#include "net.h"
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+typedef struct TcpTransport {
+    int sock;
+    msg_reader_t reader;
+} tcp_transport_t;
+
+static int tcp_send_input(transport_t *t, const client_input_t *input) {
+    tcp_transport_t *tcp = t->ctx;
+    ssize_t n = send(tcp->sock, input, sizeof(*input), 0);
+    return n == sizeof(*input) ? 0 : -1;
+}
+
+static int tcp_recv_msg(transport_t *t, msg_header_t *hdr, void *payload, int maxLen) {
+    tcp_transport_t *tcp = t->ctx;
+    return net_recv_msg(tcp->sock, &tcp->reader, hdr, payload, maxLen);
+}
+
+static int tcp_poll_fd(transport_t *t) {
+    tcp_transport_t *tcp = t->ctx;
+    return tcp->sock;
+}
+
+static int tcp_wait_ms(transport_t *t) {
+    (void)t;
+    return -1; // Dáta ohlási select na sockete
+}
+
+static void tcp_close(transport_t *t) {
+    tcp_transport_t *tcp = t->ctx;
+    close(tcp->sock);
+    free(tcp);
+    t->ctx = NULL;
+}
+
+int transport_open_tcp(transport_t *t, const char *host, int port) {
+    tcp_transport_t *tcp = malloc(sizeof(*tcp));
+    if (!tcp) return -1;
+
+    tcp->sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (tcp->sock < 0) {
+        perror("socket failed");
+        free(tcp);
+        return -1;
+    }
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = inet_addr(host);
+
+    if (connect(tcp->sock, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        perror("connect failed");
+        close(tcp->sock);
+        free(tcp);
+        return -1;
+    }
+
+    // Socket sa číta iba neblokujúco, klientska slučka nesmie nikdy stáť na recv
+    int flags = fcntl(tcp->sock, F_GETFL, 0);
+    if (fcntl(tcp->sock, F_SETFL, flags | O_NONBLOCK) < 0) {
+        perror("fcntl");
+    }
+    net_reader_init(&tcp->reader);
+
+    t->send_input = tcp_send_input;
+    t->recv_msg = tcp_recv_msg;
+    t->poll_fd = tcp_poll_fd;
+    t->wait_ms = tcp_wait_ms;
+    t->close = tcp_close;
+    t->ctx = tcp;
+    return 0;
+}
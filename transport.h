@@ -0,0 +1,28 @@
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include "shared.h"
+
+// Spojenie klienta s hrou. Sieťová aj offline varianta majú rovnaké rozhranie,
+// takže menu, vykresľovanie a ovládanie v client.c nevedia, odkiaľ hra beží.
+typedef struct Transport {
+    // Pošle vstup hráča, vráti 0 alebo -1
+    int (*send_input)(struct Transport *t, const client_input_t *input);
+    // Rovnaká sémantika ako net_recv_msg: 1 = správa, 0 = zatiaľ nič, -1 = koniec
+    int (*recv_msg)(struct Transport *t, msg_header_t *hdr, void *payload, int maxLen);
+    // Deskriptor pre select (-1 ak transport žiadny nemá)
+    int (*poll_fd)(struct Transport *t);
+    // Najdlhšie čakanie v ms, kým bude mať transport niečo nové (-1 = neobmedzene)
+    int (*wait_ms)(struct Transport *t);
+    void (*close)(struct Transport *t);
+    void *ctx;
+} transport_t;
+
+// TCP spojenie na server, vráti 0 alebo -1
+int transport_open_tcp(transport_t *t, const char *host, int port);
+
+// Hra bežiaca priamo v klientovi (vlastný engine a tick každých tickMs,
+// 0 = tick pri každom vyzdvihnutí správy), vráti 0 alebo -1
+int transport_open_offline(transport_t *t, int tickMs);
+
+#endif // TRANSPORT_H
@@ -0,0 +1,225 @@
+#include "uring.h"
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+
+static int sys_setup(unsigned entries, struct io_uring_params *p) {
+    return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int sys_enter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+    return (int)syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, NULL, 0);
+}
+
+static int sys_register(int fd, unsigned opcode, void *arg, unsigned nrArgs) {
+    return (int)syscall(__NR_io_uring_register, fd, opcode, arg, nrArgs);
+}
+
+int uring_init(uring_t *ring, unsigned entries) {
+    memset(ring, 0, sizeof(*ring));
+    ring->fd = -1;
+
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    int fd = sys_setup(entries, &p);
+    if (fd < 0) return -1;
+    ring->fd = fd;
+
+    ring->sqRingSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    ring->cqRingSize = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    // Staršie jadrá mapujú SQ a CQ ring zvlášť
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        if (ring->cqRingSize > ring->sqRingSize) ring->sqRingSize = ring->cqRingSize;
+        ring->cqRingSize = ring->sqRingSize;
+    }
+
+    ring->sqRing = mmap(NULL, ring->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        fd, IORING_OFF_SQ_RING);
+    if (ring->sqRing == MAP_FAILED) goto fail;
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        ring->cqRing = ring->sqRing;
+    } else {
+        ring->cqRing = mmap(NULL, ring->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                            fd, IORING_OFF_CQ_RING);
+        if (ring->cqRing == MAP_FAILED) goto fail;
+    }
+    ring->sqesSize = p.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = mmap(NULL, ring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED) goto fail;
+
+    char *sq = ring->sqRing;
+    char *cq = ring->cqRing;
+    ring->sqEntries = p.sq_entries;
+    ring->sqHead = (unsigned *)(sq + p.sq_off.head);
+    ring->sqTail = (unsigned *)(sq + p.sq_off.tail);
+    ring->sqMask = (unsigned *)(sq + p.sq_off.ring_mask);
+    ring->sqArray = (unsigned *)(sq + p.sq_off.array);
+    ring->cqHead = (unsigned *)(cq + p.cq_off.head);
+    ring->cqTail = (unsigned *)(cq + p.cq_off.tail);
+    ring->cqMask = (unsigned *)(cq + p.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)(cq + p.cq_off.cqes);
+    return 0;
+
+fail:
+    uring_close(ring);
+    return -1;
+}
+
+void uring_close(uring_t *ring) {
+    if (ring->sqes && ring->sqes != MAP_FAILED) munmap(ring->sqes, ring->sqesSize);
+    if (ring->cqRing && ring->cqRing != MAP_FAILED && ring->cqRing != ring->sqRing) {
+        munmap(ring->cqRing, ring->cqRingSize);
+    }
+    if (ring->sqRing && ring->sqRing != MAP_FAILED) munmap(ring->sqRing, ring->sqRingSize);
+    if (ring->fd >= 0) close(ring->fd);
+    memset(ring, 0, sizeof(*ring));
+    ring->fd = -1;
+}
+
+struct io_uring_sqe *uring_get_sqe(uring_t *ring) {
+    unsigned head = __atomic_load_n(ring->sqHead, __ATOMIC_ACQUIRE);
+    unsigned tail = *ring->sqTail + ring->sqPending;
+    if (tail - head >= ring->sqEntries) return NULL;
+
+    unsigned idx = tail & *ring->sqMask;
+    ring->sqArray[idx] = idx;
+    ring->sqPending++;
+    struct io_uring_sqe *sqe = &ring->sqes[idx];
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+int uring_submit(uring_t *ring, unsigned waitNr) {
+    unsigned submitted = ring->sqPending;
+    if (submitted > 0) {
+        // Kernel uvidí nové SQE až po posunutí tailu
+        __atomic_store_n(ring->sqTail, *ring->sqTail + submitted, __ATOMIC_RELEASE);
+        ring->sqPending = 0;
+    }
+    if (submitted == 0 && waitNr == 0) return 0;
+
+    unsigned flags = waitNr > 0 ? IORING_ENTER_GETEVENTS : 0;
+    int ret;
+    do {
+        ret = sys_enter(ring->fd, submitted, waitNr, flags);
+    } while (ret < 0 && errno == EINTR && waitNr == 0);
+    return ret;
+}
+
+struct io_uring_cqe *uring_peek_cqe(uring_t *ring) {
+    unsigned head = *ring->cqHead;
+    if (head == __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE)) return NULL;
+    return &ring->cqes[head & *ring->cqMask];
+}
+
+void uring_cqe_seen(uring_t *ring) {
+    __atomic_store_n(ring->cqHead, *ring->cqHead + 1, __ATOMIC_RELEASE);
+}
+
+int uring_buf_ring_init(uring_t *ring, uring_buf_ring_t *br, int bgid, unsigned count, unsigned size) {
+    memset(br, 0, sizeof(*br));
+    if (count == 0 || (count & (count - 1)) != 0) return -1;
+
+    size_t ringBytes = count * sizeof(struct io_uring_buf);
+    br->mapSize = ringBytes + (size_t)count * size;
+    void *mem = mmap(NULL, br->mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) return -1;
+    br->ring = mem;
+    br->bufs = (char *)mem + ringBytes;
+    br->count = count;
+    br->size = size;
+    br->bgid = bgid;
+
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (uint64_t)(uintptr_t)br->ring;
+    reg.ring_entries = count;
+    reg.bgid = (uint16_t)bgid;
+    if (sys_register(ring->fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        munmap(mem, br->mapSize);
+        br->ring = NULL;
+        return -1;
+    }
+
+    // Všetky buffre sú na začiatku k dispozícii jadru
+    br->ring->tail = 0;
+    for (unsigned bid = 0; bid < count; bid++) {
+        uring_buf_recycle(br, bid);
+    }
+    return 0;
+}
+
+void uring_buf_ring_free(uring_t *ring, uring_buf_ring_t *br) {
+    if (!br->ring) return;
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.bgid = (uint16_t)br->bgid;
+    sys_register(ring->fd, IORING_UNREGISTER_PBUF_RING, &reg, 1);
+    munmap(br->ring, br->mapSize);
+    br->ring = NULL;
+}
+
+char *uring_buf(const uring_buf_ring_t *br, unsigned bid) {
+    return br->bufs + (size_t)bid * br->size;
+}
+
+void uring_buf_recycle(uring_buf_ring_t *br, unsigned bid) {
+    unsigned short tail = br->ring->tail;
+    struct io_uring_buf *buf = &br->ring->bufs[tail & (br->count - 1)];
+    buf->addr = (uint64_t)(uintptr_t)uring_buf(br, bid);
+    buf->len = br->size;
+    buf->bid = (uint16_t)bid;
+    __atomic_store_n(&br->ring->tail, (unsigned short)(tail + 1), __ATOMIC_RELEASE);
+}
+
+void uring_prep_accept(struct io_uring_sqe *sqe, int fd, int multishot, uint64_t userData) {
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = fd;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    if (multishot) sqe->ioprio |= IORING_ACCEPT_MULTISHOT;
+    sqe->user_data = userData;
+}
+
+void uring_prep_recv(struct io_uring_sqe *sqe, int fd, int bgid, int multishot, uint64_t userData) {
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = fd;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = (uint16_t)bgid;
+    if (multishot) sqe->ioprio |= IORING_RECV_MULTISHOT;
+    sqe->user_data = userData;
+}
+
+void uring_prep_send(struct io_uring_sqe *sqe, int fd, const void *buf, unsigned len, int flags, uint64_t userData) {
+    sqe->opcode = IORING_OP_SEND;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t)(uintptr_t)buf;
+    sqe->len = len;
+    sqe->msg_flags = (uint32_t)flags;
+    sqe->user_data = userData;
+}
+
+void uring_prep_poll(struct io_uring_sqe *sqe, int fd, unsigned events, uint64_t userData) {
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+    sqe->poll32_events = events;
+    sqe->user_data = userData;
+}
+
+void uring_prep_timeout(struct io_uring_sqe *sqe, struct __kernel_timespec *ts, uint64_t userData) {
+    sqe->opcode = IORING_OP_TIMEOUT;
+    sqe->fd = -1;
+    sqe->addr = (uint64_t)(uintptr_t)ts;
+    sqe->len = 1;
+    sqe->user_data = userData;
+}
+
+void uring_prep_cancel(struct io_uring_sqe *sqe, uint64_t target, uint64_t userData) {
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = target;
+    sqe->user_data = userData;
+}
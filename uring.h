@@ -0,0 +1,73 @@
+#ifndef URING_H
+#define URING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <linux/io_uring.h>
+
+// Tenká vrstva nad io_uring cez priame syscally (bez liburing).
+// Jeden ring používa naraz jedno vlákno, prípadne ho chráni zámok volajúceho.
+
+typedef struct Uring {
+    int fd;
+    unsigned sqEntries;
+    unsigned *sqHead;
+    unsigned *sqTail;
+    unsigned *sqMask;
+    unsigned *sqArray;
+    struct io_uring_sqe *sqes;
+    unsigned sqPending;        // Pripravené SQE, ktoré ešte kernel nevidel
+    unsigned *cqHead;
+    unsigned *cqTail;
+    unsigned *cqMask;
+    struct io_uring_cqe *cqes;
+    void *sqRing;
+    size_t sqRingSize;
+    void *cqRing;
+    size_t cqRingSize;
+    size_t sqesSize;
+} uring_t;
+
+// Ring zdieľaných bufferov pre recv s IOSQE_BUFFER_SELECT
+typedef struct UringBufRing {
+    struct io_uring_buf_ring *ring;
+    char *bufs;
+    unsigned count;            // Mocnina dvojky
+    unsigned size;             // Veľkosť jedného buffera
+    int bgid;
+    size_t mapSize;
+} uring_buf_ring_t;
+
+// Vytvorí ring, vráti 0 alebo -1 (jadro bez io_uring, seccomp, ...)
+int uring_init(uring_t *ring, unsigned entries);
+
+void uring_close(uring_t *ring);
+
+// Voľné SQE (vynulované) alebo NULL ak je fronta plná
+struct io_uring_sqe *uring_get_sqe(uring_t *ring);
+
+// Odošle pripravené SQE a počká na waitNr dokončení jedným io_uring_enter,
+// vráti počet odoslaných SQE alebo -1 (errno)
+int uring_submit(uring_t *ring, unsigned waitNr);
+
+// Ďalšie dokončenie alebo NULL; po spracovaní zavolať uring_cqe_seen
+struct io_uring_cqe *uring_peek_cqe(uring_t *ring);
+void uring_cqe_seen(uring_t *ring);
+
+// Zaregistruje count bufferov po size bajtoch pod skupinou bgid, vráti 0 alebo -1
+int uring_buf_ring_init(uring_t *ring, uring_buf_ring_t *br, int bgid, unsigned count, unsigned size);
+void uring_buf_ring_free(uring_t *ring, uring_buf_ring_t *br);
+
+// Dáta buffera bid a jeho vrátenie jadru po spracovaní
+char *uring_buf(const uring_buf_ring_t *br, unsigned bid);
+void uring_buf_recycle(uring_buf_ring_t *br, unsigned bid);
+
+// Príprava SQE
+void uring_prep_accept(struct io_uring_sqe *sqe, int fd, int multishot, uint64_t userData);
+void uring_prep_recv(struct io_uring_sqe *sqe, int fd, int bgid, int multishot, uint64_t userData);
+void uring_prep_send(struct io_uring_sqe *sqe, int fd, const void *buf, unsigned len, int flags, uint64_t userData);
+void uring_prep_poll(struct io_uring_sqe *sqe, int fd, unsigned events, uint64_t userData);
+void uring_prep_timeout(struct io_uring_sqe *sqe, struct __kernel_timespec *ts, uint64_t userData);
+void uring_prep_cancel(struct io_uring_sqe *sqe, uint64_t target, uint64_t userData);
+
+#endif // URING_H